@@ -10,9 +10,14 @@ bin/mods/mcpp_world.so: \
 $(MOD_OBJ) \
 obj/world/add_client.o \
 obj/world/block_id.o \
+obj/world/column_cache.o \
 obj/world/column_container.o \
+obj/world/column_section.o \
 obj/world/column_id.o \
+obj/world/column_map.o \
 obj/world/events.o \
+obj/world/evict.o \
+obj/world/flush.o \
 obj/world/generator.o \
 obj/world/generators.o \
 obj/world/get_block.o \
@@ -21,8 +26,12 @@ obj/world/get_info.o \
 obj/world/has_skylight.o \
 obj/world/interest.o \
 obj/world/key.o \
+obj/world/light_properties.o \
+obj/world/lighting.o \
 obj/world/load.o \
 obj/world/maintenance.o \
+obj/world/pacing.o \
+obj/world/pipeline.o \
 obj/world/save.o \
 obj/world/set_block.o \
 obj/world/set_seed.o \
@@ -12,9 +12,14 @@ $(MOD_OBJ) \
 obj/world/add_client.o \
 obj/world/begin.o \
 obj/world/block_id.o \
+obj/world/column_cache.o \
 obj/world/column_container.o \
+obj/world/column_section.o \
 obj/world/column_id.o \
+obj/world/column_map.o \
 obj/world/events.o \
+obj/world/evict.o \
+obj/world/flush.o \
 obj/world/generator.o \
 obj/world/generators.o \
 obj/world/get_column.o \
@@ -22,13 +27,18 @@ obj/world/get_info.o \
 obj/world/has_skylight.o \
 obj/world/interest.o \
 obj/world/key.o \
+obj/world/light_properties.o \
+obj/world/lighting.o \
 obj/world/load.o \
 obj/world/maintenance.o \
+obj/world/pacing.o \
+obj/world/pipeline.o \
 obj/world/save.o \
 obj/world/set_seed.o \
 obj/world/populator.o \
 obj/world/populators.o \
 obj/world/process.o \
+obj/world/transaction.o \
 obj/world/world.o \
 obj/world/world_handle.o | \
 $(MOD_LIB) \
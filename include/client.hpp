@@ -480,6 +480,16 @@ namespace MCPP {
 			 *		The number of bytes sent on this connection.
 			 */
 			UInt64 Sent () const noexcept;
+			/**
+			 *	Retrieves the number of bytes which have
+			 *	been queued to be sent on this connection,
+			 *	but which have not yet been sent.
+			 *
+			 *	\return
+			 *		The number of bytes waiting to be sent
+			 *		on this connection.
+			 */
+			Word Queued () const noexcept;
 			
 	
 	
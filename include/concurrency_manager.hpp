@@ -24,49 +24,92 @@ namespace MCPP {
 	class ConcurrencyManager {
 	
 	
+		public:
+		
+		
+			/**
+			 *	The type of callback which determines a
+			 *	task's priority.
+			 *
+			 *	Returns the task's priority, tasks with
+			 *	lower priorities are dispatched first.
+			 *	Returns null if the task is stale and should
+			 *	be dropped without being invoked.
+			 */
+			typedef std::function<Nullable<Word> ()> Priority;
+	
+	
 		private:
 		
 		
+			class Task {
+			
+			
+				public:
+				
+				
+					//	The priority the task had when it
+					//	was last prioritized
+					Word Current;
+					//	Breaks ties, so that tasks of equal
+					//	priority are dispatched in the order
+					//	they were enqueued
+					UInt64 Sequence;
+					Priority Prioritize;
+					std::function<void ()> Callback;
+			
+			
+			};
+			
+			
 			ThreadPool & pool;
 			Word max;
-			Vector<std::function<void ()>> pending;
+			//	A binary heap, the task with the lowest
+			//	priority is at the front
+			Vector<Task> pending;
+			UInt64 sequence;
 			Word running;
 			Mutex lock;
 			std::function<void ()> panic;
 			
 			
-			inline void next () noexcept {
+			static bool compare (const Task &, const Task &) noexcept;
+			void push (Task);
+			Task pop () noexcept;
+			void next () noexcept;
+			void enqueue (std::function<void ()>, Priority);
+			
+			
+			template <typename T, typename... Args>
+			std::function<void ()> wrap (T && callback, Args &&... args) {
 			
-				lock.Execute([&] () {
+				auto bound=std::bind(
+					std::forward<T>(callback),
+					std::forward<Args>(args)...
+				);
 				
-					if (pending.Count()==0) {
-					
-						--running;
-					
-					} else {
-					
-						std::function<void ()> callback=std::move(pending[0]);
-						pending.Delete(0);
+				Tuple<decltype(bound)> t(std::move(bound));
+				
+				return std::bind(
+					[this] (decltype(t) t) mutable {
 					
 						try {
 						
-							pool.Enqueue(std::move(callback));
+							t.template Item<0>()();
 						
 						} catch (...) {
 						
-							--running;
-						
-							try {
-							
-								panic();
+							next();
 							
-							} catch (...) {	}
+							throw;
 						
 						}
+						
+						next();
 					
-					}
-				
-				});
+					},
+					std::move(t)
+				);
 			
 			}
 		
@@ -106,13 +149,15 @@ namespace MCPP {
 			 *	Enqueues a task to be run at the next
 			 *	opportunity.
 			 *
-			 *	Tasks are dispatched in the order that
-			 *	they are enqueued until the maximum
+			 *	Tasks are dispatched until the maximum
 			 *	allowable number are queued or running,
 			 *	at which point they remain queued inside
 			 *	the concurrency manager until another
 			 *	task managed by the concurrency manager
-			 *	completes.
+			 *	completes.  Tasks enqueued by this method
+			 *	have the highest priority, and are
+			 *	dispatched in the order that they are
+			 *	enqueued.
 			 *
 			 *	\tparam T
 			 *		The type of callback which shall
@@ -130,53 +175,68 @@ namespace MCPP {
 			template <typename T, typename... Args>
 			void Enqueue (T && callback, Args &&... args) {
 			
-				auto bound=std::bind(
-					std::forward<T>(callback),
-					std::forward<Args>(args)...
+				enqueue(
+					wrap(
+						std::forward<T>(callback),
+						std::forward<Args>(args)...
+					),
+					Priority()
 				);
-				
-				Tuple<decltype(bound)> t(std::move(bound));
-				
-				std::function<void ()> wrapped=std::bind(
-					[this] (decltype(t) t) mutable {
-					
-						try {
-						
-							t.template Item<0>()();
-						
-						} catch (...) {
-						
-							next();
-							
-							throw;
-						
-						}
-						
-						next();
-					
-					},
-					std::move(t)
+			
+			}
+			
+			
+			/**
+			 *	Enqueues a task with a priority.
+			 *
+			 *	If the task cannot be dispatched at once
+			 *	it is queued, and queued tasks are dispatched
+			 *	in order of priority.  A queued task's
+			 *	priority is determined again when it reaches
+			 *	the front of the queue, and whenever
+			 *	Reprioritize is called, so priorities may
+			 *	change while tasks wait.
+			 *
+			 *	\tparam T
+			 *		The type of callback which shall
+			 *		be asynchronously invoked.
+			 *	\tparam Args
+			 *		The type of arguments to pass through
+			 *		to the callback of type \em T.
+			 *
+			 *	\param [in] priority
+			 *		A callback which determines the task's
+			 *		priority.  It is invoked while the concurrency
+			 *		manager's internal lock is held, and so must
+			 *		not enqueue tasks.
+			 *	\param [in] callback
+			 *		The callback which shall be asynchronously
+			 *		invoked.
+			 *	\param [in] args
+			 *		The arguments to pass through to \em callback.
+			 */
+			template <typename T, typename... Args>
+			void Enqueue (Priority priority, T && callback, Args &&... args) {
+			
+				enqueue(
+					wrap(
+						std::forward<T>(callback),
+						std::forward<Args>(args)...
+					),
+					std::move(priority)
 				);
-				
-				lock.Execute([&] () mutable {
-				
-					if (running<max) {
-					
-						pool.Enqueue(std::move(wrapped));
-						
-						++running;
-					
-					} else {
-					
-						pending.Add(std::move(wrapped));
-					
-					}
-				
-				});
 			
 			}
 			
 			
+			/**
+			 *	Determines the priority of each queued
+			 *	task again, dropping those which have
+			 *	become stale.
+			 */
+			void Reprioritize ();
+			
+			
 			/**
 			 *	Retrieves the maximum number of tasks
 			 *	this concurrency manager will allow to
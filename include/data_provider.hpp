@@ -7,7 +7,9 @@
 
 
 #include <rleahylib/rleahylib.hpp>
+#include <promise.hpp>
 #include <cstdlib>
+#include <limits>
 #include <type_traits>
 #include <utility>
 
@@ -62,6 +64,80 @@ namespace MCPP {
 	};
 
 
+	/**
+	 *	Identifies a piece of a column in the
+	 *	column store.
+	 *
+	 *	Each column is stored as a header, and
+	 *	as one piece for each of its sections.
+	 */
+	class ColumnKey {
+	
+	
+		public:
+		
+		
+			/**
+			 *	The value of Section which identifies
+			 *	the header of a column.
+			 */
+			static constexpr Byte Header=std::numeric_limits<Byte>::max();
+		
+		
+			/**
+			 *	The x-coordinate of the column.
+			 */
+			Int32 X;
+			/**
+			 *	The z-coordinate of the column.
+			 */
+			Int32 Z;
+			/**
+			 *	The dimension in which the column
+			 *	resides.
+			 */
+			SByte Dimension;
+			/**
+			 *	The section of the column, or
+			 *	Header.
+			 */
+			Byte Section;
+	
+	
+	};
+	
+	
+	/**
+	 *	A piece of a column which shall be
+	 *	saved to, or deleted from, the column
+	 *	store.
+	 */
+	class ColumnData {
+	
+	
+		public:
+		
+		
+			/**
+			 *	The piece of the column.
+			 */
+			ColumnKey Key;
+			/**
+			 *	A pointer to the data which shall
+			 *	be saved, or \em nullptr if the
+			 *	piece shall be deleted.
+			 */
+			const void * Pointer;
+			/**
+			 *	The length of the data pointed to
+			 *	by Pointer.
+			 */
+			Word Length;
+	
+	
+	};
+	
+	
 	/**
 	 *	Specifies an interface to which providers
 	 *	that wish to provide data for the MCPP server
@@ -80,6 +156,24 @@ namespace MCPP {
 		
 		
 			DataProvider () noexcept;
+			
+			
+			/**
+			 *	Determines the key under which a column
+			 *	is stored in the binary store.
+			 *
+			 *	Columns stored before the column store
+			 *	existed, and columns stored by data
+			 *	providers which do not override the column
+			 *	store, are stored under these keys.
+			 *
+			 *	\param [in] key
+			 *		The key of the column.
+			 *
+			 *	\return
+			 *		The key in the binary store.
+			 */
+			static String GetBinaryKey (const ColumnKey & key);
 	
 	
 		public:
@@ -242,6 +336,175 @@ namespace MCPP {
 			virtual void DeleteBinary (const String & key) = 0;
 			
 			
+			/**
+			 *	Fetches a piece of a column from the
+			 *	column store.
+			 *
+			 *	The default implementation stores columns
+			 *	in the binary store.  Derived classes may
+			 *	override this (and SaveColumn and DeleteColumn)
+			 *	to store columns without constructing a
+			 *	string key.
+			 *
+			 *	\param [in] key
+			 *		The piece of the column to retrieve.
+			 *
+			 *	\return
+			 *		A vector of bytes if there was data
+			 *		associated with \em key, \em null
+			 *		otherwise.
+			 */
+			virtual Nullable<Vector<Byte>> GetColumn (const ColumnKey & key);
+			/**
+			 *	Saves a piece of a column to the column
+			 *	store.
+			 *
+			 *	\param [in] key
+			 *		The piece of the column to save.
+			 *	\param [in] ptr
+			 *		A pointer to the region of memory
+			 *		which shall be saved.
+			 *	\param [in] len
+			 *		The length of the memory pointed to
+			 *		by \em ptr.
+			 */
+			virtual void SaveColumn (const ColumnKey & key, const void * ptr, Word len);
+			/**
+			 *	Deletes a piece of a column from the
+			 *	column store.
+			 *
+			 *	\param [in] key
+			 *		The piece of the column to delete.
+			 */
+			virtual void DeleteColumn (const ColumnKey & key);
+			/**
+			 *	Fetches several pieces of columns from
+			 *	the column store at once.
+			 *
+			 *	The default implementation invokes
+			 *	GetColumn once for each key.  Derived
+			 *	classes for which each fetch is costly
+			 *	(e.g.\ which require a round trip to a
+			 *	server) should override this.
+			 *
+			 *	\param [in] keys
+			 *		The pieces of columns to retrieve.
+			 *
+			 *	\return
+			 *		A vector with one entry for each
+			 *		entry in \em keys, in the same order,
+			 *		each of which is the data associated
+			 *		with that key, or \em null if there
+			 *		is no such data.
+			 */
+			virtual Vector<Nullable<Vector<Byte>>> GetColumns (const Vector<ColumnKey> & keys);
+			/**
+			 *	Saves and deletes several pieces of
+			 *	columns at once.
+			 *
+			 *	The default implementation invokes
+			 *	SaveColumn or DeleteColumn once for
+			 *	each piece.
+			 *
+			 *	\param [in] data
+			 *		The pieces of columns to save or
+			 *		delete.
+			 */
+			virtual void SaveColumns (const Vector<ColumnData> & data);
+			
+			
+			/**
+			 *	Fetches binary data from the binary store
+			 *	asynchronously.
+			 *
+			 *	The default implementation, and the default
+			 *	implementations of all other asynchronous
+			 *	functions, invoke the synchronous equivalent
+			 *	and return a promise which has already been
+			 *	fulfilled.  Derived classes whose operations
+			 *	may block should override these to perform
+			 *	them on threads of their own.
+			 *
+			 *	\param [in] key
+			 *		The key whose associated binary data
+			 *		shall be retrieved.
+			 *
+			 *	\return
+			 *		A promise of a vector of bytes if there
+			 *		was binary data associated with \em key,
+			 *		\em null otherwise.
+			 */
+			virtual Promise<Nullable<Vector<Byte>>> GetBinaryAsync (String key);
+			/**
+			 *	Saves binary data to the binary store
+			 *	asynchronously.
+			 *
+			 *	\param [in] key
+			 *		The key to which binary data shall
+			 *		be saved.
+			 *	\param [in] buffer
+			 *		The data which shall be saved.
+			 *
+			 *	\return
+			 *		A promise which is fulfilled once the
+			 *		data has been saved.
+			 */
+			virtual Promise<void> SaveBinaryAsync (String key, Vector<Byte> buffer);
+			/**
+			 *	Deletes binary data from the binary store
+			 *	asynchronously.
+			 *
+			 *	\param [in] key
+			 *		The key whose associated binary data
+			 *		shall be deleted.
+			 *
+			 *	\return
+			 *		A promise which is fulfilled once the
+			 *		data has been deleted.
+			 */
+			virtual Promise<void> DeleteBinaryAsync (String key);
+			/**
+			 *	Fetches a piece of a column from the
+			 *	column store asynchronously.
+			 *
+			 *	\param [in] key
+			 *		The piece of the column to retrieve.
+			 *
+			 *	\return
+			 *		A promise of a vector of bytes if there
+			 *		was data associated with \em key, \em null
+			 *		otherwise.
+			 */
+			virtual Promise<Nullable<Vector<Byte>>> GetColumnAsync (ColumnKey key);
+			/**
+			 *	Fetches several pieces of columns from
+			 *	the column store asynchronously.
+			 *
+			 *	\param [in] keys
+			 *		The pieces of columns to retrieve.
+			 *
+			 *	\return
+			 *		A promise of the same vector GetColumns
+			 *		would return.
+			 */
+			virtual Promise<Vector<Nullable<Vector<Byte>>>> GetColumnsAsync (Vector<ColumnKey> keys);
+			/**
+			 *	Saves and deletes several pieces of
+			 *	columns asynchronously.
+			 *
+			 *	\param [in] data
+			 *		The pieces of columns to save or
+			 *		delete.  The memory these point to
+			 *		must remain valid until the returned
+			 *		promise is fulfilled.
+			 *
+			 *	\return
+			 *		A promise which is fulfilled once
+			 *		every piece has been saved or deleted.
+			 */
+			virtual Promise<void> SaveColumnsAsync (Vector<ColumnData> data);
+			
+			
 			virtual Nullable<String> RetrieveSetting (const String & setting) = 0;
 			/**
 			 *	Retrieves the value of a setting converted to
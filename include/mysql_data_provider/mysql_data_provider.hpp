@@ -7,6 +7,7 @@
 #include <safeint.hpp>
 #include <scope_guard.hpp>
 #include <pool.hpp>
+#include <thread_pool.hpp>
 #include <atomic>
 #include <cstring>
 #include <memory>
@@ -76,6 +77,16 @@ namespace MCPP {
 				}
 				
 				
+				//	For statements whose number of
+				//	parameters is not known at compile
+				//	time
+				void Parameters (MYSQL_BIND * binds) {
+				
+					if (mysql_stmt_bind_param(handle,binds)!=0) Raise();
+				
+				}
+				
+				
 				template <typename... Args>
 				void Results (Bind<Args...> & bind) {
 				
@@ -183,12 +194,46 @@ namespace MCPP {
 				};
 				
 				
+				class ChatLogEntry {
+				
+				
+					public:
+					
+					
+						String From;
+						Nullable<String> To;
+						String Message;
+						Nullable<String> Notes;
+						
+						
+						ChatLogEntry (String, Nullable<String>, String, Nullable<String>) noexcept;
+				
+				
+				};
+				
+				
 				//	Logging thread
+				//
+				//	Entries are queued and written in
+				//	batches, each batch with a single
+				//	statement
 				Vector<LogEntry> log;
+				Vector<ChatLogEntry> chat_log;
+				//	When the oldest queued entry was
+				//	queued
+				UInt64 oldest;
+				Timer timer;
 				mutable Mutex lock;
 				mutable CondVar wait;
+				//	Signalled when there's space in
+				//	the queue
+				mutable CondVar space;
 				bool stop;
 				Thread thread;
+				//	The logging thread has a connection
+				//	of its own, so that logging does not
+				//	compete for pooled connections
+				Connection log_connection;
 			
 			
 				//	Pool of connections
@@ -207,6 +252,23 @@ namespace MCPP {
 				std::atomic<Word> executed;
 				
 				
+				//	Whether columns saved before the
+				//	column table existed remain in the
+				//	binary store, determined once when
+				//	it's first needed
+				std::atomic<Word> legacy;
+				
+				
+				//	Performs asynchronous operations so
+				//	that callers do not block on the
+				//	database.
+				//
+				//	Declared last so that its workers
+				//	finish before anything they use is
+				//	destroyed
+				ThreadPool io;
+				
+				
 				template <typename T, typename... Args>
 				auto prepare (Connection &, T && callback, Args &&... args) -> decltype(
 					callback(std::forward<Args>(args)...)
@@ -220,8 +282,17 @@ namespace MCPP {
 				);
 				template <typename... Args>
 				void perform (const String &, Args &&...);
-				void write_log (const String &, Service::LogType);
+				Word queued () const noexcept;
+				void enqueue ();
+				void write_log (Vector<LogEntry> &);
+				void write_chat_log (Vector<ChatLogEntry> &);
 				void worker () noexcept;
+				bool has_legacy_columns ();
+				//	Retrieves each column which was not found
+				//	in the column table from the binary store,
+				//	with a single statement for each batch of
+				//	up to max_rows keys
+				void get_legacy_columns (const Vector<ColumnKey> &, Vector<Nullable<Vector<Byte>>> &);
 				
 				
 			public:
@@ -233,7 +304,8 @@ namespace MCPP {
 					Nullable<String> password,
 					Nullable<String> database,
 					Nullable<UInt16> port,
-					Word max
+					Word max,
+					Word io_threads
 				);
 				~DataProvider () noexcept;
 				
@@ -245,6 +317,17 @@ namespace MCPP {
 				virtual bool GetBinary (const String &, void *, Word *) override;
 				virtual void SaveBinary (const String &, const void *, Word) override;
 				virtual void DeleteBinary (const String &) override;
+				virtual Nullable<Vector<Byte>> GetColumn (const ColumnKey &) override;
+				virtual void SaveColumn (const ColumnKey &, const void *, Word) override;
+				virtual void DeleteColumn (const ColumnKey &) override;
+				virtual Vector<Nullable<Vector<Byte>>> GetColumns (const Vector<ColumnKey> &) override;
+				virtual void SaveColumns (const Vector<ColumnData> &) override;
+				virtual Promise<Nullable<Vector<Byte>>> GetBinaryAsync (String) override;
+				virtual Promise<void> SaveBinaryAsync (String, Vector<Byte>) override;
+				virtual Promise<void> DeleteBinaryAsync (String) override;
+				virtual Promise<Nullable<Vector<Byte>>> GetColumnAsync (ColumnKey) override;
+				virtual Promise<Vector<Nullable<Vector<Byte>>>> GetColumnsAsync (Vector<ColumnKey>) override;
+				virtual Promise<void> SaveColumnsAsync (Vector<ColumnData>) override;
 				virtual Nullable<String> RetrieveSetting (const String &) override;
 				virtual void SetSetting (const String &, const Nullable<String> &) override;
 				virtual void DeleteSetting (const String &) override;
@@ -257,6 +340,12 @@ namespace MCPP {
 		};
 		
 		
+		//	Creates a MySQL data provider configured
+		//	by the mysql.ini file in the same directory
+		//	as the executable
+		DataProvider * Create ();
+		
+		
 		template <typename>
 		class Output {	};
 		
@@ -317,6 +406,41 @@ namespace MCPP {
 		};
 		
 		
+		template <typename T>
+		class Binder<Output<T>> {
+		
+		
+			private:
+			
+			
+				//	On the heap so that the bind remains
+				//	valid if this object is moved
+				std::unique_ptr<T> ptr;
+				Binder<T> inner;
+				
+				
+			public:
+			
+			
+				void Initialize (MYSQL_BIND & bind, const Output<T> &) {
+				
+					ptr=std::unique_ptr<T>(new T());
+					inner.Initialize(bind,*ptr);
+				
+				}
+				
+				
+				template <Word>
+				T Get (MYSQL_BIND &, PreparedStatement &) noexcept {
+				
+					return *ptr;
+				
+				}
+		
+		
+		};
+		
+		
 		template <>
 		class Binder<String> {
 		
@@ -379,6 +379,8 @@ namespace MCPP {
 			//	Statistics
 			std::atomic<Word> sent;
 			std::atomic<Word> received;
+			//	Bytes waiting to be sent
+			std::atomic<Word> queued;
 			
 			
 			//	Endpoints
@@ -430,6 +432,7 @@ namespace MCPP {
 			UInt16 Port () const noexcept;
 			Word Sent () const noexcept;
 			Word Received () const noexcept;
+			Word Queued () const noexcept;
 	
 	
 	};
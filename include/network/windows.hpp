@@ -572,6 +572,8 @@ namespace MCPP {
 			//	Statistics
 			std::atomic<Word> sent;
 			std::atomic<Word> received;
+			//	Bytes waiting to be sent
+			std::atomic<Word> queued;
 			
 			
 			//	Callbacks
@@ -716,6 +718,16 @@ namespace MCPP {
 			 *		connection.
 			 */
 			Word Received () const noexcept;
+			/**
+			 *	Retrieves the number of bytes which have
+			 *	been queued to be sent over this connection,
+			 *	but which have not yet been sent.
+			 *
+			 *	\return
+			 *		The number of bytes waiting to be sent
+			 *		over this connection.
+			 */
+			Word Queued () const noexcept;
 			/**
 			 *	Disconnects this connection for no reason.
 			 *
@@ -512,7 +512,7 @@ namespace MCPP {
 		template <> class PacketMap<PL,CB,0x1F> : public PacketType<Single,Int16,Int16> {	};
 		template <> class PacketMap<PL,CB,0x20> : public PacketType<Int32,Array<Int32,Tuple<String,Double,Array<Int16,Tuple<UInt128,Double,Byte>>>>> {	};
 		template <> class PacketMap<PL,CB,0x21> : public PacketType<Int32,Int32,bool,UInt16,UInt16,Array<Int32,Byte>> {	};
-		//	0x22
+		template <> class PacketMap<PL,CB,0x22> : public PacketType<Int32,Int32,Int16,Array<Int32,Byte>> {	};
 		template <> class PacketMap<PL,CB,0x23> : public PacketType<Int32,Byte,UInt32,VarInt<UInt32>,Byte> {	};
 		template <> class PacketMap<PL,CB,0x24> : public PacketType<Int32,Int16,Int32,Byte,Byte,VarInt<UInt32>> {	};
 		template <> class PacketMap<PL,CB,0x25> : public PacketType<VarInt<UInt32>,Int32,Int32,Int32,Byte> {	};
@@ -2357,6 +2357,21 @@ namespace MCPP {
 				};
 				
 				
+				class MultiBlockChange : public Base, public IDPacket<0x22> {
+				
+				
+					public:
+					
+					
+						Int32 X;
+						Int32 Z;
+						Int16 Count;
+						Vector<Byte> Data;
+				
+				
+				};
+				
+				
 				class BlockChange : public Base, public IDPacket<0x23> {
 				
 				
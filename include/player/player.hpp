@@ -42,7 +42,7 @@ namespace MCPP {
 			PlayerPosition (Double x, Double y, Double z, Double stance, bool on_ground) noexcept;
 			PlayerPosition (Single yaw, Single pitch, bool on_ground) noexcept;
 			PlayerPosition (Double x, Double y, Double z, Single yaw, Single pitch, Double stance, bool on_ground) noexcept;
-			PlayerPosition () = default;
+			PlayerPosition () noexcept;
 		
 		
 			/**
@@ -71,6 +71,18 @@ namespace MCPP {
 			 *	The client's current stance.
 			 */
 			Double Stance;
+			/**
+			 *	The player's velocity along the X axis,
+			 *	in blocks per second, smoothed over
+			 *	recent packets.
+			 */
+			Double VelocityX;
+			/**
+			 *	The player's velocity along the Z axis,
+			 *	in blocks per second, smoothed over
+			 *	recent packets.
+			 */
+			Double VelocityZ;
 			
 			
 			/**
@@ -162,6 +174,21 @@ namespace MCPP {
 			PlayerPosition Position;
 			SByte Dimension;
 			std::unordered_set<ColumnID> Columns;
+			//	Columns being prefetched ahead of the
+			//	player, mapped to whether interest in
+			//	them has been acquired
+			std::unordered_map<ColumnID,bool> Prefetched;
+			//	The column, heading, and distance from
+			//	which the prefetched columns were
+			//	chosen
+			ColumnID PrefetchFrom;
+			SByte HeadingX;
+			SByte HeadingZ;
+			Word Lookahead;
+			//	Set once the player's client has
+			//	disconnected, after which no more
+			//	columns are added or prefetched
+			bool Disconnected;
 	
 	
 	};
@@ -233,6 +260,19 @@ namespace MCPP {
 			//	necessary after a player's position
 			//	has changed
 			void update_position (SmartPointer<Player> &, std::function<void ()> then=std::function<void ()>());
+			//	Determines the direction in which a
+			//	player is heading, and how many columns
+			//	ahead of them should be prefetched
+			static Tuple<SByte,SByte,Word> heading (const PlayerPosition &) noexcept;
+			//	Acquires interest in a column ahead of
+			//	a player, unless the prefetch has been
+			//	cancelled.
+			//
+			//	The column is prepared with the given
+			//	priority.
+			void prefetch (SmartPointer<Player>, ColumnID, Word);
+			//	Cancels all of a player's prefetches
+			void end_prefetch (Player &);
 			
 			
 			//	EVENT HANDLERS
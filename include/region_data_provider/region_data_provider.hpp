@@ -0,0 +1,339 @@
+#pragma once
+
+
+#include <rleahylib/rleahylib.hpp>
+#include <data_provider.hpp>
+#include <hash.hpp>
+#include <thread_pool.hpp>
+#include <memory>
+#include <unordered_map>
+#ifdef ENVIRONMENT_WINDOWS
+#include <windows.h>
+#endif
+
+
+namespace MCPP {
+
+
+	namespace Region {
+	
+	
+		//	Creates a directory if it does not
+		//	already exist
+		void MakeDirectory (const String &);
+		
+		
+		//	A file, the beginning of which is
+		//	mapped into memory, and the remainder
+		//	of which is read and written at
+		//	explicit offsets
+		class File {
+		
+		
+			private:
+			
+			
+				#ifdef ENVIRONMENT_WINDOWS
+				HANDLE handle;
+				HANDLE mapping;
+				#else
+				int handle;
+				#endif
+				void * map;
+				Word map_size;
+				
+				
+				void destroy () noexcept;
+			
+			
+			public:
+			
+			
+				File () = delete;
+				File (const File &) = delete;
+				File (File &&) = delete;
+				File & operator = (const File &) = delete;
+				File & operator = (File &&) = delete;
+				
+				
+				//	Opens the file at the given path,
+				//	creating it if it does not exist,
+				//	and maps the given number of bytes
+				//	at the beginning of the file into
+				//	memory, extending the file with
+				//	zeroes if it is too short
+				File (const String &, Word);
+				~File () noexcept;
+				
+				
+				//	Retrieves a pointer to the mapped
+				//	region at the beginning of the file
+				void * Map () const noexcept;
+				//	Retrieves the size of the file in
+				//	bytes
+				UInt64 Size () const;
+				//	Reads a certain number of bytes from
+				//	a certain offset within the file
+				void Read (UInt64, void *, Word) const;
+				//	Writes a certain number of bytes to
+				//	a certain offset within the file
+				void Write (UInt64, const void *, Word);
+				//	Waits until everything written to the
+				//	file with Write is on the disk
+				void Sync ();
+				//	Waits until the mapped region at the
+				//	beginning of the file is on the disk
+				void SyncMap ();
+		
+		
+		};
+		
+		
+		//	A file which contains all the columns
+		//	in a 32x32 region of a dimension.
+		//
+		//	The file is divided into sectors.  The
+		//	leading sectors contain an index, which
+		//	is mapped into memory, and which gives
+		//	the first sector and length of each
+		//	blob in the region.  Each column has
+		//	one blob for its header and one blob
+		//	for each of its sections.
+		class RegionFile {
+		
+		
+			public:
+			
+			
+				//	The number of columns along each
+				//	side of a region
+				static constexpr Word Width=32;
+				//	The number of blobs each column
+				//	may store
+				static constexpr Word Slots=17;
+				//	The number of entries in the index
+				static constexpr Word Entries=Width*Width*Slots;
+				//	The size of each sector in bytes
+				static constexpr Word SectorSize=4096;
+			
+			
+			private:
+			
+			
+				class Entry {
+				
+				
+					public:
+					
+					
+						//	The first sector of the blob,
+						//	zero if there is no blob
+						UInt32 Sector;
+						//	The length of the blob in
+						//	bytes
+						UInt32 Length;
+				
+				
+				};
+			
+			
+			public:
+			
+			
+				//	The number of sectors occupied by
+				//	the index
+				static constexpr Word HeaderSectors=((Entries*sizeof(Entry))+SectorSize-1)/SectorSize;
+			
+			
+			private:
+			
+			
+				File file;
+				//	Mapped into memory from the
+				//	beginning of the file
+				Entry * index;
+				//	Which sectors of the file are
+				//	in use
+				Vector<bool> used;
+				mutable RWLock lock;
+				
+				
+				static Word sectors (Word) noexcept;
+				//	The number of sectors a blob of a
+				//	certain length occupies, every blob
+				//	occupies at least one sector, since
+				//	a sector of zero indicates that there
+				//	is no blob
+				static Word occupied (Word) noexcept;
+				Word allocate (Word);
+				void release (Word, Word) noexcept;
+			
+			
+			public:
+			
+			
+				RegionFile (const String &);
+				
+				
+				//	Retrieves the blob at a certain
+				//	index, or null if there is no blob
+				//	at that index
+				Nullable<Vector<Byte>> Get (Word);
+				//	Retrieves the blob at a certain index
+				//	into a buffer.
+				//
+				//	Returns false if there is no blob at
+				//	that index.  Otherwise the last argument
+				//	is set to the length of the blob, and
+				//	as much of the blob as will fit is
+				//	copied into the buffer.
+				bool Get (Word, void *, Word *);
+				//	Replaces many blobs at once, given by
+				//	their indices, with a null pointer
+				//	deleting the blob at that index.
+				//
+				//	New blobs are written to free sectors
+				//	(or sectors appended to the file) and
+				//	flushed to disk before the index refers
+				//	to them, and the sectors they replace
+				//	are only freed once the index has been
+				//	flushed, so that after a crash each
+				//	entry refers either to the old blob or
+				//	to the new one
+				void Save (const Vector<Tuple<Word,const void *,Word>> &);
+				//	Replaces the blob at a certain index
+				void Save (Word, const void *, Word);
+				//	Deletes the blob at a certain index,
+				//	freeing the sectors it occupies
+				void Delete (Word);
+		
+		
+		};
+		
+		
+		//	Stores columns in region files on the
+		//	local disk, and delegates everything
+		//	else to another data provider.
+		//
+		//	Columns are never read from the other
+		//	data provider, so columns saved there
+		//	before switching to this data provider
+		//	are not found and will be generated
+		//	again
+		class DataProvider : public MCPP::DataProvider {
+		
+		
+			private:
+			
+			
+				typedef Tuple<SByte,Int32,Int32> RegionID;
+				
+				
+				class OpenRegion {
+				
+				
+					public:
+					
+					
+						//	Callers retain a reference while
+						//	they use the file, so that it is
+						//	not closed out from under them
+						std::shared_ptr<RegionFile> File;
+						//	When the file was last used, for
+						//	the purposes of deciding which
+						//	file to close
+						UInt64 LastUsed;
+				
+				
+				};
+				
+				
+				//	Data provider which handles everything
+				//	other than columns
+				std::unique_ptr<MCPP::DataProvider> inner;
+				//	The directory in which region files
+				//	are stored
+				String directory;
+				
+				
+				//	Open region files
+				std::unordered_map<
+					RegionID,
+					OpenRegion
+				> regions;
+				//	Incremented each time a region file
+				//	is used
+				UInt64 uses;
+				//	The number of region files which may
+				//	be open at once, each holds a file
+				//	handle and a mapping of its index.
+				//
+				//	Files which are in use are not closed,
+				//	so this may be exceeded briefly
+				Word max_open;
+				Mutex regions_lock;
+				
+				
+				//	Performs asynchronous operations on
+				//	region files so that callers do not
+				//	block on the disk.
+				//
+				//	Declared last so that it's stopped
+				//	before the region files are closed
+				ThreadPool io;
+				
+				
+				//	Removes the least recently used region
+				//	file which is not in use, if any, so it
+				//	may be closed once the lock is released
+				std::shared_ptr<RegionFile> close_idle ();
+				//	Retrieves the region file which stores
+				//	a piece of a column, and its index
+				//	within that file
+				std::shared_ptr<RegionFile> get (const ColumnKey &, Word &);
+				//	Determines whether a key refers to
+				//	a column, and if so retrieves the
+				//	region file which stores it and its
+				//	index within that file
+				bool get (const String &, std::shared_ptr<RegionFile> &, Word &);
+			
+			
+			public:
+			
+			
+				DataProvider (std::unique_ptr<MCPP::DataProvider>, String);
+				
+				
+				virtual DataProviderInfo GetInfo () override;
+				virtual void WriteLog (const String &, Service::LogType) override;
+				virtual void WriteChatLog (const String &, const Vector<String> &, const String &, const Nullable<String> &) override;
+				virtual Nullable<Vector<Byte>> GetBinary (const String &) override;
+				virtual bool GetBinary (const String &, void *, Word *) override;
+				virtual void SaveBinary (const String &, const void *, Word) override;
+				virtual void DeleteBinary (const String &) override;
+				virtual Nullable<Vector<Byte>> GetColumn (const ColumnKey &) override;
+				virtual void SaveColumn (const ColumnKey &, const void *, Word) override;
+				virtual void DeleteColumn (const ColumnKey &) override;
+				virtual void SaveColumns (const Vector<ColumnData> &) override;
+				virtual Promise<Nullable<Vector<Byte>>> GetBinaryAsync (String) override;
+				virtual Promise<void> SaveBinaryAsync (String, Vector<Byte>) override;
+				virtual Promise<void> DeleteBinaryAsync (String) override;
+				virtual Promise<Nullable<Vector<Byte>>> GetColumnAsync (ColumnKey) override;
+				virtual Promise<Vector<Nullable<Vector<Byte>>>> GetColumnsAsync (Vector<ColumnKey>) override;
+				virtual Promise<void> SaveColumnsAsync (Vector<ColumnData>) override;
+				virtual Nullable<String> RetrieveSetting (const String &) override;
+				virtual void SetSetting (const String &, const Nullable<String> &) override;
+				virtual void DeleteSetting (const String &) override;
+				virtual void InsertValue (const String &, const String &) override;
+				virtual void DeleteValues (const String &, const String &) override;
+				virtual void DeleteValues (const String &) override;
+				virtual Vector<String> GetValues (const String &) override;
+		
+		
+		};
+	
+	
+	}
+
+
+}
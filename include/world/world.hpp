@@ -8,14 +8,17 @@
 
 #include <rleahylib/rleahylib.hpp>
 #include <client.hpp>
+#include <data_provider.hpp>
 #include <event.hpp>
 #include <hash.hpp>
 #include <mod.hpp>
 #include <packet.hpp>
 #include <thread_pool.hpp>
 #include <cstddef>
+#include <exception>
 #include <functional>
 #include <initializer_list>
+#include <list>
 #include <memory>
 #include <new>
 #include <random>
@@ -250,6 +253,51 @@ namespace MCPP {
 			
 			}
 			
+			
+			/**
+			 *	Determines whether this block is
+			 *	identical to another block.
+			 *
+			 *	\param [in] other
+			 *		The block to compare against.
+			 *
+			 *	\return
+			 *		\em true if this block and \em other
+			 *		have the same type, metadata, light,
+			 *		skylight, and flags, \em false
+			 *		otherwise.
+			 */
+			inline bool operator == (const Block & other) const noexcept {
+			
+				return (
+					(flags==other.flags) &&
+					(type==other.type) &&
+					(skylightmetadata==other.skylightmetadata) &&
+					(light==other.light)
+				);
+			
+			}
+			
+			
+			/**
+			 *	Determines whether this block differs
+			 *	from another block.
+			 *
+			 *	\param [in] other
+			 *		The block to compare against.
+			 *
+			 *	\return
+			 *		\em false if this block and \em other
+			 *		have the same type, metadata, light,
+			 *		skylight, and flags, \em true
+			 *		otherwise.
+			 */
+			inline bool operator != (const Block & other) const noexcept {
+			
+				return !(*this==other);
+			
+			}
+	
 	
 	};
 	
@@ -682,6 +730,61 @@ namespace MCPP {
 	 *		\em dimension, \em false otherwise.
 	 */
 	void SetHasSkylight (SByte dimension, bool has_skylight) noexcept;
+	/**
+	 *	Retrieves the amount by which light is
+	 *	reduced when it passes through a certain
+	 *	type of block.
+	 *
+	 *	\param [in] type
+	 *		The type of block of interest.
+	 *
+	 *	\return
+	 *		A value between 0 and 15 inclusive,
+	 *		where 15 means that \em type blocks
+	 *		light entirely.  Light is always
+	 *		reduced by at least one as it
+	 *		spreads, except for skylight which
+	 *		travels straight down through blocks
+	 *		for which this is 0.
+	 */
+	Byte GetLightOpacity (UInt16 type) noexcept;
+	/**
+	 *	Sets the internal value used by
+	 *	GetLightOpacity for a certain type of
+	 *	block.
+	 *
+	 *	Not thread safe.
+	 *
+	 *	\param [in] type
+	 *		The type of block of interest.
+	 *	\param [in] opacity
+	 *		A value between 0 and 15 inclusive.
+	 */
+	void SetLightOpacity (UInt16 type, Byte opacity) noexcept;
+	/**
+	 *	Retrieves the amount of light a certain
+	 *	type of block emits.
+	 *
+	 *	\param [in] type
+	 *		The type of block of interest.
+	 *
+	 *	\return
+	 *		A value between 0 and 15 inclusive.
+	 */
+	Byte GetLightEmission (UInt16 type) noexcept;
+	/**
+	 *	Sets the internal value used by
+	 *	GetLightEmission for a certain type of
+	 *	block.
+	 *
+	 *	Not thread safe.
+	 *
+	 *	\param [in] type
+	 *		The type of block of interest.
+	 *	\param [in] emission
+	 *		A value between 0 and 15 inclusive.
+	 */
+	void SetLightEmission (UInt16 type, Byte emission) noexcept;
 	
 	
 	/**
@@ -700,6 +803,158 @@ namespace MCPP {
 	};
 	
 	
+	class ColumnSection {
+	
+	
+		public:
+		
+		
+			//	The number of blocks in a section
+			static constexpr Word Count=16*16*16;
+		
+		
+			//	Creates a section in which every
+			//	block is air
+			ColumnSection ();
+			ColumnSection (const ColumnSection &);
+			ColumnSection & operator = (const ColumnSection &) = delete;
+			
+			
+			//	Retrieves the block at a given offset
+			//	within this section
+			Block Get (Word) const noexcept;
+			//	Sets the block at a given offset within
+			//	this section, growing the palette and
+			//	widening the indices as necessary
+			void Set (Word, Block);
+			//	Determines whether a block may be set
+			//	in this section without allocating, i.e.
+			//	whether Set will change the section in
+			//	place without invalidating any memory
+			//	a concurrent reader may be using
+			bool Fits (Block) const noexcept;
+			//	Rebuilds the palette, discarding entries
+			//	which are no longer referenced, and narrows
+			//	the indices to the smallest width which can
+			//	address the result
+			void Compact ();
+			//	Determines whether every block in this
+			//	section is the given block, i.e. whether
+			//	it could be replaced by a null section
+			//	if that block is the block a null section
+			//	implies
+			//
+			//	This is determined from the palette, and
+			//	so may return false for a section which
+			//	has palette entries which are no longer
+			//	used until the section is compacted
+			bool IsAir (Block air=Block()) const noexcept;
+			//	Determines whether no block in this section
+			//	has a non-zero type
+			bool IsEmpty () const noexcept;
+			//	Determines whether any block in this
+			//	section has a type which requires the
+			//	"add" array to be sent to clients
+			bool RequiresAdd () const noexcept;
+			//	The number of bytes of memory used
+			//	to store this section
+			Word Memory () const noexcept;
+			//	Appends a representation of this section
+			//	to a buffer of bytes
+			void Serialize (Vector<Byte> &) const;
+			//	Attempts to populate this section from
+			//	a buffer of bytes, advancing the pointer
+			//	past the consumed bytes.
+			//
+			//	Returns false if the bytes do not represent
+			//	a valid section.
+			bool Deserialize (const Byte * &, const Byte *);
+			
+			
+		private:
+		
+		
+			//	The distinct blocks in this section,
+			//	the packed indices refer to entries
+			//	in this palette
+			Vector<Block> palette;
+			//	The width of each index in bits,
+			//	always a power of two (or zero if
+			//	the palette has only one entry)
+			Word bits;
+			//	The packed indices.
+			//
+			//	Blocks are set in place while threads
+			//	read without the column's lock (see
+			//	Fits), so each word is atomic.  A word
+			//	is stored with release semantics after
+			//	any palette entry it refers to is added,
+			//	and loaded with acquire semantics, so a
+			//	reader which sees a new index also sees
+			//	the new entry.
+			std::unique_ptr<std::atomic<UInt64> []> indices;
+			//	The number of blocks with a non-zero
+			//	type, and the number of blocks whose
+			//	type requires the "add" array
+			Word non_air;
+			Word extended;
+			
+			
+			void tally (Block, bool) noexcept;
+			Word get_index (Word) const noexcept;
+			void set_index (Word, Word) noexcept;
+			void resize (Word);
+	
+	
+	};
+	
+	
+	//	A frozen view of a column, taken under
+	//	the column's lock, which may be read
+	//	without holding any lock.
+	//
+	//	Sections are shared with the column
+	//	until the column writes to them, at
+	//	which point the column makes a copy
+	class ColumnSnapshot {
+	
+	
+		public:
+		
+		
+			//	The ID of the column
+			ColumnID ID;
+			Biome Biomes [16*16];
+			bool Populated;
+			//	Bitmask of the sections, from bottom
+			//	to top, which had been modified since
+			//	the column was last saved when the
+			//	snapshot was taken
+			UInt16 Dirty;
+			//	The sections of the column, from
+			//	bottom to top, null sections are
+			//	entirely air
+			std::shared_ptr<const ColumnSection> Sections [16];
+			//	The height map of the column
+			UInt16 Heights [16*16];
+			
+			
+			//	Gets a buffer of bytes which represents
+			//	the header of the column -- its populated
+			//	flag, biomes, which of its sections are
+			//	present, and its height map -- in the
+			//	backing store.
+			Vector<Byte> SerializeHeader () const;
+			//	Gets a buffer of bytes which represents
+			//	a certain section of the column in the
+			//	backing store, or null if that section
+			//	is entirely air.
+			Nullable<Vector<Byte>> SerializeSection (Word) const;
+	
+	
+	};
+	
+	
 	class ColumnContainer {
 	
 		
@@ -715,24 +970,10 @@ namespace MCPP {
 			ColumnContainer (ColumnID) noexcept;
 		
 		
-			//	The layout of the proceeding
-			//	three fields is identical to
-			//	the layout in which they will
-			//	be saved to the backing store,
-			//	this removes the need for any
-			//	sort of copying
-			Block Blocks [16*16*16*16];
 			Biome Biomes [16*16];
 			bool Populated;
 			
 			
-			//	The size of the memory region
-			//	within each column container
-			//	which should be saved and
-			//	loaded
-			static constexpr Word Size=sizeof(Populated)+sizeof(Blocks)+sizeof(Biomes);
-			
-			
 			//	Retrieves the ID of this column
 			ColumnID ID () const noexcept;
 			//	Retrieves a 0x33 packet which represents
@@ -741,22 +982,6 @@ namespace MCPP {
 			//	Retrieves a 0x33 packet which unloads
 			//	the contained column from a client
 			PacketType GetUnload () const;
-			//	Checks the column's state.
-			//
-			//	If the column is in the required state, or
-			//	a state more advanced than that state,
-			//	returns true immediately.
-			//
-			//	If the column is not in the required state,
-			//	but is being processed, blocks until the
-			//	required amount of processing is done, and
-			//	then returns true.
-			//
-			//	If the column is not in the required state,
-			//	and is not being processed, returns false
-			//	at once -- the caller MUST do the required
-			//	processing on the column.
-			bool WaitUntil (ColumnState) noexcept;
 			//	Sets the columns state.
 			//
 			//	Wakes all pending threads and fires all
@@ -794,6 +1019,12 @@ namespace MCPP {
 			//	otherwise returns false and the caller should
 			//	perform that required processing immediately.
 			bool Check (ColumnState) noexcept;
+			//	Waits until the column is in a certain
+			//	state, or a state more advanced than that
+			//	state, or until a certain number of
+			//	milliseconds have passed, whichever comes
+			//	first
+			void Sleep (ColumnState, Word) noexcept;
 			//	Retrieves the column's current state
 			ColumnState GetState () const noexcept;
 			//	Sends the column to all currently
@@ -825,28 +1056,166 @@ namespace MCPP {
 			//
 			//	Not thread safe.
 			bool CanUnload () const noexcept;
-			//	Sets a block within this column, sending
-			//	the appropriate packet
-			void SetBlock (BlockID, Block);
-			//	Gets a block within this column
+			//	Retrieves the time, in milliseconds as
+			//	given by World::now, at which the column
+			//	last lost its last player or interest.
+			//
+			//	Only meaningful if the column can be
+			//	unloaded.
+			UInt64 Released () const noexcept;
+			//	Sets a block within this column, buffering
+			//	the change to be sent to clients.
+			//
+			//	Returns true if the column did not have
+			//	buffered changes before this call and
+			//	does afterwards, in which case the caller
+			//	must arrange for Flush to be called.
+			//
+			//	The light values of the block are not
+			//	changed, the lighting engine maintains
+			//	them.
+			bool SetBlock (BlockID, Block);
+			//	Sets many blocks within this column,
+			//	given by their offsets within it, under a
+			//	single acquisition of the column's lock.
+			//
+			//	Returns true in the same circumstances
+			//	as SetBlock.
+			bool SetBlocks (const Vector<Tuple<Word,Block>> &);
+			//	As SetBlocks, except that the caller
+			//	must already have acquired the column's
+			//	lock with Acquire, so that blocks may be
+			//	read and set in one critical section
+			bool SetBlocksAcquired (const Vector<Tuple<Word,Block>> &);
+			//	Sets the light or, if the last argument
+			//	is true, skylight of the block at a certain
+			//	offset within this column without sending
+			//	any packets
+			void SetLight (Word, Byte, bool);
+			//	Sends all buffered block changes to
+			//	clients
+			void Flush ();
+			//	Gets a block within this column.
+			//
+			//	Does not acquire the column's lock unless
+			//	the block is being written at the same
+			//	time.
 			Block GetBlock (BlockID) const noexcept;
+			//	Gets several blocks within this column,
+			//	given by their offsets within it, as they
+			//	all were at a single point in time.
+			//
+			//	Does not acquire the column's lock unless
+			//	the column is being written at the same
+			//	time.
+			void GetBlocks (const Word *, Block *, Word) const noexcept;
+			//	Gets the height of the column at a certain
+			//	x and z offset within it -- one more than the
+			//	y-coordinate of the highest block which is not
+			//	air, or zero if there is no such block
+			Word GetHeight (Word, Word) const noexcept;
+			//	Computes the height map if the column was
+			//	loaded from a header which did not contain
+			//	it.
+			//
+			//	Not thread safe.
+			void EnsureHeights () noexcept;
+			//	Sets the block at a certain offset within
+			//	this column without sending any packets or
+			//	marking the column dirty.
+			//
+			//	Not thread safe -- intended for use by
+			//	generators, which have exclusive access
+			//	to the column.
+			void Write (Word, Block);
+			//	Gets the block at a certain offset within
+			//	this column.
+			//
+			//	Blocks in sections which are not stored
+			//	are air, with full skylight if the column's
+			//	dimension has skylight.
+			//
+			//	Not thread safe.
+			Block Read (Word) const noexcept;
 			//	Acquires the column's internal lock
 			void Acquire () const noexcept;
 			//	Release the column's internal lock
 			void Release () const noexcept;
+			//	Acquires exclusive write access to this
+			//	column on behalf of a writer, identified
+			//	by a non-zero integer.
+			//
+			//	If the last argument is false and another
+			//	writer has access, returns false at once,
+			//	otherwise waits until that writer ends its
+			//	access.
+			//
+			//	A writer which already has access may
+			//	acquire it again, and must end its access
+			//	once for each time it was acquired.
+			bool BeginWrite (Word, bool);
+			//	Ends exclusive write access to this
+			//	column
+			void EndWrite () noexcept;
 			//	Determines whether or not the column
 			//	is "dirty".
 			//
 			//	Not thread safe
 			bool Dirty () const noexcept;
-			//	Clears the "dirty" flag.
+			//	Retrieves a bitmask of the sections,
+			//	from bottom to top, which have been
+			//	modified since the column was last
+			//	saved.
+			//
+			//	Not thread safe
+			UInt16 DirtySections () const noexcept;
+			//	Clears the "dirty" flag, and marks
+			//	all sections clean.
 			void Clean () noexcept;
 			//	Gets a string which represents
 			//	the co-ordinates of this column
 			String ToString () const;
-			//	Gets a pointer through which this
-			//	column may be loaded or saved
-			void * Get () noexcept;
+			//	Compacts the palette of each modified
+			//	section, and releases modified sections
+			//	which have become entirely air.
+			//
+			//	Not thread safe.
+			void Compact ();
+			//	Takes a snapshot of this column, which
+			//	may be serialized without holding the
+			//	column's lock.
+			//
+			//	Does not copy any blocks.
+			//
+			//	Not thread safe.
+			ColumnSnapshot Snapshot () const;
+			//	Populates this column from a buffer of
+			//	bytes retrieved from the backing store.
+			//
+			//	On success the bitmask of sections which
+			//	are stored separately, and which must be
+			//	passed to DeserializeSection, is returned
+			//	through the second argument.
+			//
+			//	Returns false if the buffer does not
+			//	represent a valid column, in which case
+			//	the column's contents are unspecified.
+			//
+			//	Not thread safe.
+			bool Deserialize (const Vector<Byte> &, UInt16 &);
+			//	Populates a certain section of this column
+			//	from a buffer of bytes retrieved from the
+			//	backing store.
+			//
+			//	Returns false if the buffer does not
+			//	represent a valid section.
+			//
+			//	Not thread safe.
+			bool DeserializeSection (Word, const Vector<Byte> &);
+			//	The approximate number of bytes of memory
+			//	used to store the blocks and biomes of this
+			//	column
+			Word Memory () const noexcept;
 			
 			
 		private:
@@ -856,6 +1225,19 @@ namespace MCPP {
 			//	coordinates and the dimension in
 			//	which it resides
 			ColumnID id;
+			//	The 16x16x16 sections which make up the
+			//	column, from bottom to top.
+			//
+			//	A null section is entirely air, and
+			//	occupies no memory beyond the pointer.
+			//
+			//	Sections may be shared with snapshots,
+			//	and must be copied before they are
+			//	modified if they are
+			std::shared_ptr<ColumnSection> sections [16];
+			//	Approximate number of bytes used by
+			//	sections and biomes
+			std::atomic<Word> memory;
 			//	The column's current state
 			//
 			//	If this is not equal to target
@@ -884,44 +1266,171 @@ namespace MCPP {
 			//	So long as there is "interest" in
 			//	a column, it will not be unloaded
 			std::atomic<Word> interest;
+			//	When the column was last left with
+			//	no players or no interest
+			std::atomic<UInt64> released;
 			//	Whether column data has been sent
 			//	to clients or not
 			bool sent;
-			//	Whether this column has been modified
-			//	since it was last saved
+			//	Whether this column's header -- its
+			//	populated flag and biomes -- has been
+			//	modified since it was last saved
 			bool dirty;
+			//	Bitmask of sections, from bottom to
+			//	top, which have been modified since
+			//	they were last saved
+			UInt16 dirty_sections;
+			//	The height at each x and z offset, x
+			//	varying fastest, maintained as blocks
+			//	are written
+			UInt16 heights [16*16];
+			//	Whether the height map must be computed
+			//	because it was not loaded
+			bool heights_pending;
+			//	The serialized, deflated 0x21 packet
+			//	which represents this column, or null
+			//	if it has not been generated since the
+			//	column last changed
+			Nullable<Vector<Byte>> cache;
+			//	Block changes which have not yet
+			//	been sent to clients, in the format
+			//	of the data of a 0x22 packet
+			Vector<Byte> changes;
+			//	The number of buffered changes in
+			//	each section
+			Word section_changes [16];
+			//	Incremented before and after each change
+			//	to the sections, so that blocks may be read
+			//	without the lock and discarded if a change
+			//	was in progress
+			std::atomic<UInt64> version;
+			//	The number of threads reading without
+			//	the lock
+			mutable std::atomic<Word> readers;
+			//	The sections which threads reading without
+			//	the lock use
+			std::atomic<ColumnSection *> views [16];
+			//	Sections which have been replaced, but
+			//	which threads reading without the lock
+			//	may still be using.  They're freed once
+			//	there are no such threads.
+			Vector<std::shared_ptr<ColumnSection>> retired;
+			//	The writer which has exclusive write
+			//	access to this column, zero if none,
+			//	and the number of times it acquired
+			//	that access
+			Word writer;
+			Word writes;
+			
+			
+			bool deserialize_legacy (const Vector<Byte> &);
+			void replace (Word, std::shared_ptr<ColumnSection>);
+			void publish () noexcept;
+			void reclaim () noexcept;
+			bool read (const Word *, Block *, Word) const noexcept;
+			Block empty () const noexcept;
+			void update_height (Word, bool) noexcept;
+			const Vector<Byte> & get_chunk_data ();
+			void flush ();
+			void set_block (Word, Block);
+			bool buffered (bool);
 		
 	
 	};
 	
 	
-	#pragma GCC diagnostic push
-	#pragma GCC diagnostic ignored "-Winvalid-offsetof"
-	static_assert(
-		(
-			offsetof(
-				ColumnContainer,
-				Blocks
-			)==0
-		) &&
-		(
-			offsetof(
-				ColumnContainer,
-				Biomes
-			)==(16*16*16*16*sizeof(Block))
-		) &&
-		(
-			offsetof(
-				ColumnContainer,
-				Populated
-			)==(
-				(16*16*16*16*sizeof(Block))+(16*16*sizeof(Byte))
-			)
-		) &&
-		(sizeof(bool)==sizeof(Byte)),
-		"ColumnContainer layout incorrect"
-	);
-	#pragma GCC diagnostic pop
+	//	Maps column IDs to loaded columns.
+	//
+	//	The map is divided into shards, each
+	//	with its own lock, so that lookups
+	//	of unrelated columns do not contend
+	//	with one another
+	class ColumnMap {
+	
+	
+		public:
+		
+		
+			//	The number of shards
+			static constexpr Word Shards=64;
+		
+		
+		private:
+		
+		
+			class Shard {
+			
+			
+				public:
+				
+				
+					std::unordered_map<
+						ColumnID,
+						std::unique_ptr<ColumnContainer>
+					> Map;
+					mutable RWLock Lock;
+			
+			
+			};
+			
+			
+			Shard shards [Shards];
+			
+			
+			Shard & get_shard (const ColumnID &) noexcept;
+			const Shard & get_shard (const ColumnID &) const noexcept;
+			
+			
+		public:
+		
+		
+			//	Retrieves a column, creating it if
+			//	it doesn't exist and the boolean
+			//	argument is true.
+			//
+			//	Interest is acquired in the returned
+			//	column before the lock is released.
+			//
+			//	Returns a null pointer if the column
+			//	does not exist and was not created.
+			ColumnContainer * Get (ColumnID, bool);
+			//	Ends interest in the column with a
+			//	given ID, if it is loaded
+			void EndInterest (ColumnID) noexcept;
+			//	Removes a column from the map if it
+			//	can be unloaded.
+			//
+			//	The column's lock must be held.
+			//
+			//	Returns the removed column, or a null
+			//	pointer if the column could not be
+			//	unloaded.
+			std::unique_ptr<ColumnContainer> Remove (ColumnContainer &);
+			//	Retrieves a list of all loaded
+			//	columns.
+			//
+			//	Each shard is locked in turn, so
+			//	this does not block lookups of the
+			//	map as a whole.
+			Vector<ColumnContainer *> Snapshot () const;
+			//	Invokes a callback for each loaded
+			//	column, while the lock on the shard
+			//	containing that column is held
+			template <typename T>
+			void Enumerate (T && callback) const {
+			
+				for (const auto & shard : shards) shard.Lock.Read([&] () {
+				
+					for (const auto & pair : shard.Map) callback(
+						static_cast<const ColumnContainer &>(*pair.second)
+					);
+				
+				});
+			
+			}
+	
+	
+	};
 	
 	
 	/**
@@ -937,11 +1446,20 @@ namespace MCPP {
 	enum class BlockWriteStrategy {
 
 		/**
-		 *	The world's state is guaranteed
-		 *	not to change after the handle
-		 *	is acquired.  Other threads may
-		 *	read from the world, but may not
-		 *	write to it.
+		 *	Each column the handle reads from
+		 *	or writes to is guaranteed not to
+		 *	change until the handle commits,
+		 *	rolls back, or is destroyed.  Other
+		 *	threads may read from those columns,
+		 *	but may not write to them.
+		 *
+		 *	Handles which touch different columns
+		 *	do not wait on one another.  If
+		 *	acquiring a column could deadlock, or
+		 *	a column must be prepared while the
+		 *	handle holds other columns, the
+		 *	handle's changes are rolled back
+		 *	and TransactionConflict is thrown.
 		 */
 		Transactional,
 		/**
@@ -1020,6 +1538,59 @@ namespace MCPP {
 	};
 	
 	
+	/**
+	 *	The result of an operation on a region
+	 *	of the world within one of the columns
+	 *	that the region intersects.
+	 */
+	class RegionResult {
+	
+	
+		public:
+		
+		
+			/**
+			 *	The column.
+			 */
+			ColumnID ID;
+			/**
+			 *	\em true if the column could be
+			 *	retrieved, \em false otherwise, in
+			 *	which case no blocks within it were
+			 *	read or written.
+			 */
+			bool Retrieved;
+			/**
+			 *	The number of blocks within the column
+			 *	which were read or set.
+			 */
+			Word Count;
+	
+	
+	};
+	
+	
+	/**
+	 *	Thrown when a transactional WorldHandle
+	 *	cannot acquire a column without risking
+	 *	deadlock.
+	 *
+	 *	When this is thrown the handle's changes
+	 *	have already been rolled back, and the
+	 *	transaction may be retried.
+	 */
+	class TransactionConflict : public std::exception {
+	
+	
+		public:
+		
+		
+			virtual const char * what () const noexcept override;
+	
+	
+	};
+	
+	
 	/**
 	 *	\cond
 	 */
@@ -1059,10 +1630,18 @@ namespace MCPP {
 			//	means that this object has been
 			//	moved
 			mutable World * world;
-			//	True if this handle holds the
-			//	world lock, and write operations
-			//	may proceed seamlessly
-			mutable bool locked;
+			//	Identifies this handle to columns
+			//	to which it has exclusive write
+			//	access
+			Word id;
+			//	The columns which this handle holds
+			//	for its transaction, interest is held
+			//	in each
+			mutable Vector<ColumnContainer *> held;
+			//	Each block this handle's transaction
+			//	has set, and the block it replaced,
+			//	oldest first
+			mutable Vector<Tuple<ColumnContainer *,BlockID,Block,Block>> undo;
 			//	A pointer to the last column
 			//	that this handle accessed, for
 			//	caching reasons
@@ -1079,9 +1658,21 @@ namespace MCPP {
 			
 			
 			inline void destroy () noexcept;
+			inline bool transacting () const noexcept;
+			void acquire (ColumnContainer &) const;
+			void release () const noexcept;
+			void rollback () const;
+			template <typename T>
+			auto write_to (ColumnContainer & column, T callback) const -> decltype(callback());
 			inline ColumnContainer * get_column_impl (ColumnID) const;
 			inline ColumnContainer * get_column (ColumnID, bool) const;
 			inline bool set_impl (ColumnContainer *, BlockID, Block, bool) const;
+			template <typename T>
+			Word set_region (ColumnContainer &, const BlockID &, const BlockID &, const BlockID &, const BlockID &, bool, T) const;
+			template <typename T>
+			Vector<RegionResult> write_region (BlockID, BlockID, bool, T) const;
+			template <typename T>
+			Vector<RegionResult> read_region (BlockID, BlockID, T) const;
 			
 			
 		public:
@@ -1150,22 +1741,218 @@ namespace MCPP {
 			 *		\em null otherwise.
 			 */
 			Nullable<Block> Get (BlockID id, std::nothrow_t no_throw) const;
+			/**
+			 *	Attempts to retrieve the height of the
+			 *	world at a certain x and z co-ordinate.
+			 *
+			 *	\exception std::runtime_error
+			 *		Thrown if the height could not be
+			 *		retrieved.
+			 *
+			 *	\param [in] x
+			 *		The x co-ordinate.
+			 *	\param [in] z
+			 *		The z co-ordinate.
+			 *	\param [in] dimension
+			 *		The dimension.
+			 *
+			 *	\return
+			 *		One more than the y co-ordinate of
+			 *		the highest block at \em x and \em z
+			 *		which is not air, or zero if all
+			 *		blocks at \em x and \em z are air.
+			 */
+			Word GetHeight (Int32 x, Int32 z, SByte dimension) const;
+			/**
+			 *	Attempts to retrieve the height of the
+			 *	world at a certain x and z co-ordinate.
+			 *
+			 *	\param [in] x
+			 *		The x co-ordinate.
+			 *	\param [in] z
+			 *		The z co-ordinate.
+			 *	\param [in] dimension
+			 *		The dimension.
+			 *	\param [in] no_throw
+			 *		An object of type \em std::nothrow_t
+			 *		which disambiguates this overload.
+			 *
+			 *	\return
+			 *		One more than the y co-ordinate of
+			 *		the highest block at \em x and \em z
+			 *		which is not air, or zero if all
+			 *		blocks at \em x and \em z are air,
+			 *		\em null if the height could not be
+			 *		retrieved.
+			 */
+			Nullable<Word> GetHeight (Int32 x, Int32 z, SByte dimension, std::nothrow_t no_throw) const;
+			
+			
+			/**
+			 *	Determines the number of blocks in the
+			 *	cuboid region between two blocks.
+			 *
+			 *	\param [in] a
+			 *		One corner of the region.
+			 *	\param [in] b
+			 *		The opposite corner of the region.
+			 *
+			 *	\return
+			 *		The number of blocks in the region,
+			 *		including those on its faces.
+			 */
+			static Word Volume (BlockID a, BlockID b) noexcept;
+			/**
+			 *	Sets every block in a cuboid region.
+			 *
+			 *	Each column the region intersects is
+			 *	locked once, and its changes are sent
+			 *	to clients together.
+			 *
+			 *	\param [in] a
+			 *		One corner of the region.
+			 *	\param [in] b
+			 *		The opposite corner of the region.
+			 *		The region is in the dimension of
+			 *		\em a.
+			 *	\param [in] block
+			 *		The block to set throughout the
+			 *		region.
+			 *	\param [in] force
+			 *		If \em true events shall not have
+			 *		the opportunity to block the setting
+			 *		of blocks.  Defaults to \em true.
+			 *
+			 *	\return
+			 *		The result for each column the region
+			 *		intersects.
+			 */
+			Vector<RegionResult> Fill (BlockID a, BlockID b, Block block, bool force=true) const;
+			/**
+			 *	Replaces every block of a certain type
+			 *	and metadata in a cuboid region.
+			 *
+			 *	\param [in] a
+			 *		One corner of the region.
+			 *	\param [in] b
+			 *		The opposite corner of the region.
+			 *		The region is in the dimension of
+			 *		\em a.
+			 *	\param [in] find
+			 *		The block to replace.  Only the type
+			 *		and metadata are compared.
+			 *	\param [in] replace
+			 *		The block with which to replace
+			 *		blocks matching \em find.
+			 *	\param [in] force
+			 *		If \em true events shall not have
+			 *		the opportunity to block the setting
+			 *		of blocks.  Defaults to \em true.
+			 *
+			 *	\return
+			 *		The result for each column the region
+			 *		intersects.
+			 */
+			Vector<RegionResult> Replace (BlockID a, BlockID b, Block find, Block replace, bool force=true) const;
+			/**
+			 *	Copies a cuboid region.
+			 *
+			 *	The region is copied one destination column
+			 *	at a time, in an order such that the source
+			 *	and destination may overlap.  Blocks which
+			 *	could not be read, or which would be
+			 *	copied above the top of the world, are
+			 *	not copied.
+			 *
+			 *	\param [in] a
+			 *		One corner of the source region.
+			 *	\param [in] b
+			 *		The opposite corner of the source
+			 *		region.  The region is in the dimension
+			 *		of \em a.
+			 *	\param [in] destination
+			 *		The corner of the destination region
+			 *		with the smallest co-ordinates.
+			 *	\param [in] force
+			 *		If \em true events shall not have
+			 *		the opportunity to block the setting
+			 *		of blocks.  Defaults to \em true.
+			 *
+			 *	\return
+			 *		The result for each column the
+			 *		destination region intersects.
+			 */
+			Vector<RegionResult> CopyRegion (BlockID a, BlockID b, BlockID destination, bool force=true) const;
+			/**
+			 *	Retrieves every block in a cuboid region.
+			 *
+			 *	The blocks within each column the region
+			 *	intersects are read as they all were at
+			 *	a single point in time.
+			 *
+			 *	Blocks are stored with x varying fastest,
+			 *	then z, then y, starting from the corner
+			 *	with the smallest co-ordinates.
+			 *
+			 *	\param [in] a
+			 *		One corner of the region.
+			 *	\param [in] b
+			 *		The opposite corner of the region.
+			 *		The region is in the dimension of
+			 *		\em a.
+			 *	\param [out] buffer
+			 *		A buffer large enough to hold the
+			 *		number of blocks given by Volume.
+			 *		Blocks within columns which could
+			 *		not be retrieved are not written.
+			 *
+			 *	\return
+			 *		The result for each column the region
+			 *		intersects.
+			 */
+			Vector<RegionResult> Read (BlockID a, BlockID b, Block * buffer) const;
 			
 			
+			/**
+			 *	Ends this handle's transaction, making
+			 *	its changes permanent and allowing other
+			 *	handles to write to the columns it held.
+			 *
+			 *	The handle may continue to be used, in
+			 *	which case it begins a new transaction.
+			 *
+			 *	Transactions are committed when their
+			 *	handle is destroyed.
+			 */
+			void Commit () const noexcept;
+			/**
+			 *	Ends this handle's transaction, undoing
+			 *	every block it set.
+			 *
+			 *	Set events are fired for each block as
+			 *	it's restored, newest change first, and
+			 *	with the check events skipped, so that
+			 *	listeners which observed a change also
+			 *	observe it being undone.
+			 *
+			 *	The handle may continue to be used, in
+			 *	which case it begins a new transaction.
+			 */
+			void Rollback () const;
 			/**
 			 *	Determines whether this handle currently
-			 *	has exclusive access to the world.
+			 *	has exclusive write access to any part of
+			 *	the world.
 			 *
 			 *	If the return value of this function is
 			 *	\em false, and no other handles are held
 			 *	by the current thread, attempting to
-			 *	acquire a transactional handle, or attempting
-			 *	to write through a different handle is
+			 *	write through a different handle is
 			 *	guaranteed not to deadlock.
 			 *
 			 *	\return
 			 *		\em true if this world handle currently
-			 *		holds an exclusive lock on the world,
+			 *		holds columns for its transaction,
 			 *		\em false otherwise.
 			 */
 			bool Exclusive () const noexcept;
@@ -1246,6 +2033,71 @@ namespace MCPP {
 	};
 	
 	
+	/**
+	 *	Information about one of the stages
+	 *	through which columns pass as they are
+	 *	prepared.
+	 */
+	class WorldStageInfo {
+	
+	
+		public:
+		
+		
+			/**
+			 *	The number of columns which may be
+			 *	processed by this stage at once, zero
+			 *	if unlimited.
+			 */
+			Word Limit;
+			/**
+			 *	The number of columns which may wait
+			 *	for this stage before further columns
+			 *	are processed by the thread which
+			 *	passes them to it, zero if unlimited.
+			 */
+			Word Capacity;
+			/**
+			 *	The number of columns currently being
+			 *	processed by this stage.
+			 */
+			Word Running;
+			/**
+			 *	The number of columns currently waiting
+			 *	for this stage.
+			 */
+			Word Queued;
+			/**
+			 *	The greatest number of columns which
+			 *	have waited for this stage at once.
+			 */
+			Word MaxQueued;
+			/**
+			 *	The number of columns which have been
+			 *	processed by this stage.
+			 */
+			Word Completed;
+			/**
+			 *	The number of columns which were processed
+			 *	by the thread which passed them to this stage
+			 *	because too many were waiting.
+			 */
+			Word Overflowed;
+			/**
+			 *	The number of nanoseconds columns have
+			 *	spent waiting for this stage.
+			 */
+			UInt64 Waiting;
+			/**
+			 *	The number of nanoseconds columns have
+			 *	spent being processed by this stage.
+			 */
+			UInt64 Processing;
+	
+	
+	};
+	
+	
 	/**
 	 *	A snapshot of information about the
 	 *	world at a single point in time.
@@ -1330,10 +2182,65 @@ namespace MCPP {
 			 */
 			Word Count;
 			/**
-			 *	The number of bytes of memory being
-			 *	used to hold raw column data.
+			 *	The approximate number of bytes of
+			 *	memory being used to hold column data.
 			 */
 			Word Size;
+			
+			
+			/**
+			 *	The number of times a column has
+			 *	been loaded from the cache of
+			 *	recently unloaded columns rather
+			 *	than the backing store.
+			 */
+			Word CacheHits;
+			/**
+			 *	The number of columns in the cache
+			 *	of recently unloaded columns.
+			 */
+			Word Cached;
+			/**
+			 *	The number of bytes of compressed
+			 *	column data in the cache of recently
+			 *	unloaded columns.
+			 */
+			Word CacheSize;
+			
+			
+			/**
+			 *	The number of bytes of memory which
+			 *	may be used to hold column data before
+			 *	columns are unloaded early, zero if
+			 *	unlimited.
+			 */
+			Word MemoryBudget;
+			/**
+			 *	The number of loaded columns which had
+			 *	no players and no interest when columns
+			 *	were last considered for unloading.
+			 */
+			Word Idle;
+			/**
+			 *	The number of bytes of memory being used
+			 *	by the columns counted by \em Idle.
+			 */
+			Word IdleSize;
+			/**
+			 *	The number of columns which have been
+			 *	unloaded early to keep within the memory
+			 *	budget.
+			 */
+			Word Evicted;
+			
+			
+			/**
+			 *	Information about each stage through which
+			 *	columns pass as they are prepared:  Loading,
+			 *	generating, populating, and sending, in that
+			 *	order.
+			 */
+			WorldStageInfo Stages [4];
 	
 	
 	};
@@ -1386,6 +2293,8 @@ namespace MCPP {
 	
 	
 		friend class WorldHandle;
+		friend class ColumnContainer;
+		friend class LightEngine;
 	
 	
 		private:
@@ -1443,6 +2352,21 @@ namespace MCPP {
 			//	Number of nanoseconds spent populating
 			//	columns
 			std::atomic<UInt64> populate_time;
+			//	Number of times a column has been
+			//	loaded from the cache
+			std::atomic<Word> cache_hits;
+			//	Number of columns that have been
+			//	unloaded before the unload delay
+			//	had passed to keep within the
+			//	memory budget
+			std::atomic<Word> evicted;
+			//	The number of columns which had no
+			//	players and no interest, and the
+			//	number of bytes they were using, when
+			//	columns were last considered for
+			//	unloading
+			std::atomic<Word> idle;
+			std::atomic<Word> idle_memory;
 		
 		
 			//	Contains loaded world generators
@@ -1467,15 +2391,12 @@ namespace MCPP {
 			
 			
 			//	Contains the world
-			std::unordered_map<
-				ColumnID,
-				std::unique_ptr<ColumnContainer>
-			> world;
-			mutable Mutex lock;
+			ColumnMap world;
 			
 			
-			//	World lock
-			Mutex wlock;
+			//	Used to give each handle a distinct
+			//	identity when writing to columns
+			std::atomic<Word> writers;
 			
 			
 			//	Only one thread is allowed to
@@ -1483,6 +2404,190 @@ namespace MCPP {
 			//	at any one time, to avoid race
 			//	conditions while saving
 			Mutex maintenance_lock;
+			//	The number of workers which shall
+			//	save and unload columns concurrently
+			//	during maintenance, zero if half the
+			//	threads in the thread pool should be
+			//	used.  At least one thread in the pool
+			//	is always left for other work
+			Word maintenance_concurrency;
+			//	Whether columns are being unloaded,
+			//	either by maintenance or by eviction.
+			//
+			//	Eviction skips its pass rather than
+			//	waiting while this is set, maintenance
+			//	waits for eviction to finish
+			bool maintaining;
+			Mutex maintaining_lock;
+			CondVar maintaining_wait;
+			bool begin_unloading (bool wait);
+			void end_unloading () noexcept;
+			
+			
+			//	Measures time for the purposes of
+			//	deciding when columns are unloaded
+			mutable Timer clock;
+			//	How long, in milliseconds, a column
+			//	must have had no players and no
+			//	interest before it is unloaded
+			Word unload_delay;
+			//	The number of bytes of column data
+			//	which may be loaded before columns
+			//	are unloaded without waiting for
+			//	the unload delay, zero if unlimited
+			Word memory_budget;
+			//	How often, in milliseconds, clean
+			//	columns are unloaded between
+			//	maintenance cycles
+			Word evict_interval;
+			
+			
+			//	A column waiting for a stage
+			class PendingColumn {
+			
+			
+				public:
+				
+				
+					//	Lower priorities are processed
+					//	first
+					Word Priority;
+					//	Breaks ties, so that columns of
+					//	equal priority are processed in
+					//	the order they arrived
+					UInt64 Sequence;
+					//	How long the column has been
+					//	waiting
+					Timer Queued;
+					std::function<void (Timer)> Callback;
+			
+			
+			};
+			
+			
+			//	Columns are prepared in stages, each
+			//	of which processes a limited number of
+			//	columns at once on the thread pool
+			class Stage {
+			
+			
+				public:
+				
+				
+					mutable Mutex Lock;
+					//	A binary heap of columns waiting for
+					//	this stage, the column with the lowest
+					//	priority is at the front
+					Vector<PendingColumn> Queue;
+					UInt64 Sequence;
+					//	The number of columns being processed
+					Word Running;
+					//	The number of columns which may be
+					//	processed at once, zero if unlimited
+					Word Limit;
+					//	The number of columns which may wait,
+					//	zero if unlimited
+					Word Capacity;
+					Word MaxQueued;
+					std::atomic<Word> Completed;
+					std::atomic<Word> Overflowed;
+					std::atomic<UInt64> Waiting;
+					std::atomic<UInt64> Processing;
+			
+			
+			};
+			
+			
+			Stage load_stage;
+			Stage generate_stage;
+			Stage populate_stage;
+			Stage send_stage;
+			//	Columns which stages have started, and
+			//	which may be processed either by the
+			//	thread pool or by a thread waiting for
+			//	a column
+			Vector<std::function<void ()>> ready;
+			Mutex ready_lock;
+			
+			
+			//	A retrieval from the backing store
+			//	which is waiting to be made together
+			//	with others
+			class PendingFetch {
+			
+			
+				public:
+				
+				
+					Vector<ColumnKey> Keys;
+					Promise<Vector<Nullable<Vector<Byte>>>> Result;
+			
+			
+			};
+			
+			
+			//	Retrievals are collected for a short
+			//	while, so that the columns loaded when,
+			//	for example, a player joins are retrieved
+			//	in a few large batches rather than one
+			//	by one
+			Vector<PendingFetch> fetches;
+			//	The number of keys in all pending
+			//	retrievals
+			Word fetch_count;
+			//	Whether pending retrievals are scheduled
+			//	to be made
+			bool fetch_scheduled;
+			Mutex fetch_lock;
+			//	How long, in milliseconds, retrievals
+			//	are collected, zero if they are made
+			//	at once
+			Word fetch_window;
+			//	If this many keys are pending, they
+			//	are retrieved without waiting
+			Word fetch_batch;
+			
+			
+			//	Columns which were unloaded while
+			//	clean, kept compressed in memory
+			//	so that they may be loaded again
+			//	without the backing store
+			class CachedColumn {
+			
+			
+				public:
+				
+				
+					//	The compressed header
+					Vector<Byte> Header;
+					//	The compressed sections, from
+					//	bottom to top, null sections are
+					//	entirely air
+					Nullable<Vector<Byte>> Sections [16];
+					//	The number of compressed bytes
+					Word Size;
+					//	Where this column is in the order
+					//	in which columns are evicted
+					std::list<ColumnID>::iterator Position;
+			
+			
+			};
+			
+			
+			std::unordered_map<
+				ColumnID,
+				std::shared_ptr<CachedColumn>
+			> cache;
+			//	Least recently unloaded first
+			std::list<ColumnID> cache_order;
+			//	The number of compressed bytes in
+			//	the cache
+			Word cache_size;
+			mutable Mutex cache_lock;
+			//	The maximum number of compressed bytes
+			//	which may be cached, zero if columns
+			//	shall not be cached
+			Word cache_budget;
 			
 			
 			//	Maps clients to the columns associated
@@ -1492,6 +2597,73 @@ namespace MCPP {
 				std::unordered_set<ColumnID>
 			> clients;
 			Mutex clients_lock;
+			
+			
+			//	Paces the sending of columns to a
+			//	single client
+			class Pacer {
+			
+			
+				public:
+				
+				
+					Mutex Lock;
+					//	The number of bytes of column data
+					//	which may be sent before the client's
+					//	budget is exhausted, may be negative
+					//	if a large column overdrew it
+					Int64 Tokens;
+					//	When tokens were last added
+					Timer Refilled;
+					//	Column sends which have been deferred,
+					//	in the order they shall be sent
+					Vector<Tuple<ColumnID,Vector<Byte>>> Deferred;
+					//	Whether deferred sends are scheduled
+					//	to be retried
+					bool Scheduled;
+			
+			
+			};
+			
+			
+			std::unordered_map<
+				SmartPointer<Client>,
+				std::shared_ptr<Pacer>
+			> pacers;
+			Mutex pacers_lock;
+			//	The rate, in bytes per second, at which
+			//	column data may be sent to each client,
+			//	zero if unlimited
+			Word send_rate;
+			//	The number of bytes of column data which
+			//	may be sent to a client in a burst
+			Word send_burst;
+			//	If more than this many bytes are waiting
+			//	to be sent to a client, column sends to
+			//	that client are deferred, zero if
+			//	unlimited
+			Word send_high_water;
+			
+			
+			//	Columns which have block changes
+			//	which have not been sent to clients
+			//
+			//	Interest is held in each of these
+			//	columns until it is flushed
+			std::unordered_set<ColumnContainer *> changed;
+			Mutex changed_lock;
+			//	How often, in milliseconds, buffered
+			//	block changes are sent to clients
+			Word flush_interval;
+			
+			
+			//	Blocks around which light must be
+			//	updated, and columns across the borders
+			//	of which light must be propagated, on
+			//	the next flush
+			Vector<BlockID> relight_blocks;
+			Vector<ColumnID> relight_columns;
+			Mutex relight_lock;
 		
 		
 			//	PRIVATE METHODS
@@ -1500,31 +2672,176 @@ namespace MCPP {
 			
 			//	Generates a column
 			void generate (ColumnContainer &);
+			//	Generates and lights a column, and
+			//	updates statistics and logs
+			void do_generate (ColumnContainer &);
+			//	Populates a column, and updates
+			//	statistics and logs
+			void do_populate (ColumnContainer &, const WorldHandle *);
 			//	Processes a column up until
 			//	a certain satisfactory point
 			void process (ColumnContainer &, const WorldHandle * handle=nullptr);
+			//	Processes a column up until a certain
+			//	satisfactory point without waiting,
+			//	passing the column from stage to stage
+			void process_async (ColumnContainer &, Word);
+			//	Sets the state of a column which has
+			//	been processed by a stage, and passes
+			//	it to the next stage if it requires
+			//	further processing
+			void advance (ColumnContainer &, ColumnState, bool, Word);
+			//	Passes a column which has just become
+			//	populated to the stage which sends it
+			//	to attached clients
+			void process_send (ColumnContainer &, bool, Word);
+			//	Passes a column to a stage with a
+			//	certain priority.
+			//
+			//	The callback is invoked on the thread
+			//	pool once the stage may process another
+			//	column, and no column with a lower
+			//	priority is waiting, or at once on the
+			//	calling thread if too many columns are
+			//	waiting.  It must call complete once the
+			//	column has been processed.
+			void dispatch (Stage &, Word, std::function<void (Timer)>);
+			//	Orders columns waiting for a stage
+			static bool later (const PendingColumn &, const PendingColumn &) noexcept;
+			//	Invokes a callback passed to a stage on
+			//	the thread pool
+			void start (Stage &, Timer, std::function<void (Timer)>);
+			//	Informs a stage that a column has been
+			//	processed, starting the next waiting
+			//	column if there is one
+			void complete (Stage &, Timer) noexcept;
+			//	Processes the column which was started
+			//	by a stage least recently, if there is
+			//	one, returning true if there was
+			bool run_ready ();
+			//	Returns a promise which is completed once
+			//	a column is populated, processing the column
+			//	with a certain priority if nothing else is
+			Promise<void> when_populated (ColumnContainer &, Word);
+			//	Returns once a column is in a certain state,
+			//	processing the column if nothing else is.
+			//
+			//	While another thread processes the column,
+			//	the calling thread processes columns started
+			//	by stages rather than sleeping, unless the
+			//	handle through which the column is being
+			//	accessed holds columns or is populating.
+			void wait_until (ColumnContainer &, ColumnState, const WorldHandle *);
 			//	Loads a column from the backing
 			//	store (or attempts to).
 			//
 			//	Returns the state the column is
 			//	in after being loaded.
 			ColumnState load (ColumnContainer &);
+			//	Loads a column from the backing store
+			//	(or attempts to) asynchronously.
+			//
+			//	The callback is invoked on the thread
+			//	pool with the state the column is in
+			//	after being loaded.
+			void load (ColumnContainer &, std::function<void (ColumnState)>);
+			//	Retrieves columns from the backing store
+			//	asynchronously, together with other
+			//	retrievals made at about the same time
+			Promise<Vector<Nullable<Vector<Byte>>>> fetch (Vector<ColumnKey>);
+			//	Makes all pending retrievals in a single
+			//	batch, true if invoked because the batch
+			//	was scheduled rather than because it
+			//	became full
+			void fetch_pending (bool);
+			//	Deserializes the header of a column.
+			//
+			//	Returns the keys of the sections which
+			//	must also be retrieved, or null if the
+			//	column must be generated.
+			Nullable<Vector<ColumnKey>> load_header (ColumnContainer &, const Nullable<Vector<Byte>> &);
+			//	Deserializes the sections retrieved from
+			//	the backing store, returning the state the
+			//	column is in after being loaded
+			ColumnState load_sections (ColumnContainer &, const Vector<ColumnKey> &, const Vector<Nullable<Vector<Byte>>> &);
+			//	Updates statistics and logs once a column
+			//	has been loaded
+			void record_load (const ColumnContainer &, ColumnState, UInt64);
+			//	Compresses and caches a column which
+			//	has been unloaded, evicting the least
+			//	recently unloaded columns if the cache
+			//	is over budget
+			void cache_column (const ColumnSnapshot &);
+			//	Removes a column from the cache,
+			//	returning it if it was present
+			std::shared_ptr<CachedColumn> uncache_column (ColumnID);
+			//	Loads a column from the cache,
+			//	returning the state the column is
+			//	in after being loaded
+			ColumnState load_cached (ColumnContainer &, CachedColumn &);
 			//	Populates a column
 			void populate (ColumnContainer &, const WorldHandle *);
+			//	Computes the light of a column which has
+			//	just been generated, without regard to
+			//	its neighbours.
+			//
+			//	Not thread safe.
+			void light (ColumnContainer &);
+			//	Arranges for the light around a block
+			//	to be updated on the next flush
+			void relight (BlockID);
+			//	Arranges for light to be propagated
+			//	across the borders of a column on the
+			//	next flush
+			void relight (ColumnID);
+			//	Updates the light around every block,
+			//	and across the borders of every column,
+			//	which requires it
+			void update_light ();
 			//	Does maintenance work -- scans and
 			//	saves all columns, unloads columns
 			//	that are inactive.
 			//
 			//	Should be invoked periodically.
 			void maintenance ();
+			//	Retrieves the time, in milliseconds,
+			//	against which columns' release times
+			//	are measured
+			UInt64 now () const noexcept;
+			//	Determines which of a set of columns
+			//	shall be unloaded: those which have had
+			//	no players and no interest for the unload
+			//	delay and, while the world is over its
+			//	memory budget, those of the remainder
+			//	which were released least recently.
+			//
+			//	Each column is mapped to the time at which
+			//	it was released, and whether it was chosen
+			//	to keep within the memory budget.
+			std::unordered_map<ColumnContainer *,Tuple<UInt64,bool>> unloadable (const Vector<ColumnContainer *> &);
+			//	Unloads a column chosen by unloadable,
+			//	unless it has gained a player or interest
+			//	since, or it is dirty and the last argument
+			//	is true.
+			//
+			//	The maintenance lock must be held.
+			//
+			//	Returns true if the column was unloaded.
+			bool unload (ColumnContainer &, const Tuple<UInt64,bool> &, bool);
+			//	Unloads clean columns between maintenance
+			//	cycles.
+			//
+			//	Should be invoked periodically.
+			void evict ();
 			//	Saves a column
 			//
 			//	The maintenance lock must be held
 			//	before calling this function
 			//
-			//	Returns whether or not the column
-			//	was actually saved
-			bool save (ColumnContainer &);
+			//	Returns a promise of whether or not
+			//	the column was actually saved, which
+			//	is fulfilled once the backing store
+			//	has saved the column
+			Promise<bool> save (ColumnContainer &);
 			
 			//	GET/SET
 			
@@ -1559,13 +2876,67 @@ namespace MCPP {
 			//	into them
 			void cleanup_events () noexcept;
 			
+			//	BLOCK CHANGES
+			
+			//	Records that a column has buffered
+			//	block changes which must be flushed
+			void add_changed (ColumnContainer &);
+			//	Flushes buffered block changes to
+			//	clients, and then reschedules itself
+			void flush ();
+			
+			//	COLUMN SEND PACING
+			
+			//	Creates a pacer for a client which
+			//	has just connected
+			void begin_pacing (const SmartPointer<Client> &);
+			//	Retrieves the pacer for a client, or
+			//	null if the client has disconnected
+			std::shared_ptr<Pacer> get_pacer (const SmartPointer<Client> &);
+			//	Adds tokens to a pacer's budget and
+			//	determines whether a column may be sent
+			//	now.  The pacer's lock must be held.
+			bool can_send (const Client &, Pacer &) noexcept;
+			//	Determines how long to wait, in
+			//	milliseconds, before retrying deferred
+			//	sends.  The pacer's lock must be held.
+			Word retry_after (const Pacer &) const noexcept;
+			//	Sends a column to a client, or defers
+			//	it if the client's budget is exhausted
+			//	or too many bytes are waiting to be sent
+			//	to it.  If a send of the same column is
+			//	deferred, its data is replaced.
+			void send_column (const SmartPointer<Client> &, ColumnID, const Vector<Byte> &);
+			//	Determines whether the send of a column
+			//	to a client has been deferred
+			bool is_deferred (const SmartPointer<Client> &, ColumnID);
+			//	Cancels the deferred send of a column to
+			//	a client, returning true if there was
+			//	one
+			bool cancel_column (const SmartPointer<Client> &, ColumnID);
+			//	Sends as many deferred columns as the
+			//	pacer allows, rescheduling itself if some
+			//	remain deferred
+			void pump (SmartPointer<Client>, std::shared_ptr<Pacer>);
+			//	Drops a client's pacer and its deferred
+			//	sends
+			void end_pacing (const SmartPointer<Client> &);
+			
+			//	TRANSACTIONS
+			
+			//	Attempts a transaction, after a certain
+			//	number of conflicts, completing the promise
+			//	once it commits or fails, or scheduling the
+			//	next attempt on the thread pool if it
+			//	conflicts
+			void transact (std::shared_ptr<std::function<void (const WorldHandle &)>>, BlockAccessStrategy, Word, Promise<void>) noexcept;
+			
 			//	MISC
 
 			//	Retrieves the key that will be associated
-			//	with a given column in the backing
-			//	store
-			String key (ColumnID) const;
-			String key (const ColumnContainer &) const;
+			//	with a given section of a given column
+			//	(or with its header) in the backing store
+			static ColumnKey key (ColumnID, Byte section=ColumnKey::Header) noexcept;
 		
 		
 		public:
@@ -1685,21 +3056,25 @@ namespace MCPP {
 			 *	The column will not be unloaded until this
 			 *	client is removed from it.
 			 *
+			 *	Does not wait for the column to be loaded,
+			 *	generated, or populated.
+			 *
 			 *	\param [in] client
 			 *		The client to add.
 			 *	\param [in] id
 			 *		The column to which to add \em client.
-			 *	\param [in] async
-			 *		If \em true the function will return at once
-			 *		if the column specified by \em id is already
-			 *		undergoing processing by another thread.  The
-			 *		column will be sent to \em client at some
-			 *		indeterminate point in the future.  If \em false
-			 *		the method will block in the aforementioned situation
-			 *		until the column has been prepared by the
-			 *		other thread and sent.  Defaults to \em false.
-			 */
-			void Add (SmartPointer<Client> client, ColumnID id, bool async=false);
+			 *	\param [in] priority
+			 *		If the column must be prepared, the priority
+			 *		with which it is prepared.  Columns with lower
+			 *		priorities are prepared first.  Defaults to
+			 *		zero.
+			 *
+			 *	\return
+			 *		A promise which is completed once the
+			 *		column has been populated, at which
+			 *		point it is sent to \em client.
+			 */
+			Promise<void> Add (SmartPointer<Client> client, ColumnID id, Word priority=0);
 			/**
 			 *	Removes a particular client from a particular column.
 			 *
@@ -1864,8 +3239,18 @@ namespace MCPP {
 			 *		If \em true the column will be generated
 			 *		and populated, otherwise the column will
 			 *		simply be placed into memory.
+			 *	\param [in] priority
+			 *		If the column must be prepared, the priority
+			 *		with which it is prepared.  Columns with lower
+			 *		priorities are prepared first.  Defaults to
+			 *		zero.
+			 *
+			 *	\return
+			 *		A promise which is completed once the
+			 *		column has been generated and populated,
+			 *		or at once if \em prepare is \em false.
 			 */
-			void Interested (ColumnID id, bool prepare=true);
+			Promise<void> Interested (ColumnID id, bool prepare=true, Word priority=0);
 			/**
 			 *	Ends interest in a column, allowing the
 			 *	column to once again be unloaded if appropriate.
@@ -1896,6 +3281,38 @@ namespace MCPP {
 			 *		be read and written.
 			 */
 			WorldHandle Begin (BlockWriteStrategy write=BlockWriteStrategy::Dirty, BlockAccessStrategy access=BlockAccessStrategy::Populate);
+			/**
+			 *	Invokes a callback with a transactional
+			 *	handle, retrying it as many times as
+			 *	necessary until it completes without
+			 *	conflicting with another transaction.
+			 *
+			 *	The first attempt is made on the calling
+			 *	thread.  After a conflict the transaction
+			 *	is retried on the thread pool after a
+			 *	short random delay, so that the calling
+			 *	thread does not wait.
+			 *
+			 *	If the callback throws any other
+			 *	exception, its changes are rolled back
+			 *	and the returned promise fails with that
+			 *	exception.
+			 *
+			 *	\param [in] callback
+			 *		The callback to invoke.  Since it
+			 *		may be invoked more than once, and on
+			 *		other threads, it should have no effects
+			 *		beyond the handle it is passed.
+			 *	\param [in] access
+			 *		The strategy that shall be used to
+			 *		access the world.  Defaults to
+			 *		\em BlockAccessStrategy::Populate.
+			 *
+			 *	\return
+			 *		A promise which is fulfilled once the
+			 *		transaction commits.
+			 */
+			Promise<void> Transact (std::function<void (const WorldHandle &)> callback, BlockAccessStrategy access=BlockAccessStrategy::Populate);
 	
 	
 	};
@@ -33,3 +33,12 @@ CREATE TABLE `binary` (
 	`key` varchar(191) PRIMARY KEY,
 	`value` mediumblob NOT NULL
 );
+
+CREATE TABLE `columns` (
+	`x` int NOT NULL,
+	`z` int NOT NULL,
+	`dimension` tinyint NOT NULL,
+	`section` tinyint unsigned NOT NULL,
+	`value` mediumblob NOT NULL,
+	PRIMARY KEY (`x`,`z`,`dimension`,`section`)
+);
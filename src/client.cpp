@@ -413,6 +413,13 @@ namespace MCPP {
 	}
 	
 	
+	Word Client::Queued () const noexcept {
+	
+		return conn->Queued();
+	
+	}
+	
+	
 	void Client::log (const Packet & packet, ProtocolState state, ProtocolDirection direction, const Vector<Byte> & buffer, const Vector<Byte> & ciphertext) const {
 	
 		auto & server=Server::Get();
@@ -1,4 +1,5 @@
 #include <concurrency_manager.hpp>
+#include <algorithm>
 
 
 namespace MCPP {
@@ -8,7 +9,7 @@ namespace MCPP {
 		ThreadPool & pool,
 		Word max,
 		std::function<void ()> panic
-	) noexcept : pool(pool), max(max), running(0), panic(std::move(panic)) {
+	) noexcept : pool(pool), max(max), sequence(0), running(0), panic(std::move(panic)) {
 	
 		//	Sanity check
 		if (this->max==0) this->max=1;
@@ -16,6 +17,188 @@ namespace MCPP {
 	}
 	
 	
+	bool ConcurrencyManager::compare (const Task & a, const Task & b) noexcept {
+	
+		//	The standard library's heap algorithms
+		//	place the greatest element at the front,
+		//	so tasks which should run later are
+		//	"less"
+		if (a.Current==b.Current) return a.Sequence>b.Sequence;
+		
+		return a.Current>b.Current;
+	
+	}
+	
+	
+	void ConcurrencyManager::push (Task task) {
+	
+		pending.Add(std::move(task));
+		std::push_heap(pending.begin(),pending.end(),compare);
+	
+	}
+	
+	
+	ConcurrencyManager::Task ConcurrencyManager::pop () noexcept {
+	
+		std::pop_heap(pending.begin(),pending.end(),compare);
+		Task retr=std::move(pending[pending.Count()-1]);
+		pending.Delete(pending.Count()-1);
+		
+		return retr;
+	
+	}
+	
+	
+	void ConcurrencyManager::next () noexcept {
+	
+		//	Stale tasks are destroyed once the lock
+		//	is released, since destroying them may
+		//	run arbitrary code
+		Vector<Task> dropped;
+	
+		lock.Execute([&] () {
+		
+			try {
+			
+				while (pending.Count()!=0) {
+				
+					auto task=pop();
+					
+					//	The task's priority may have changed
+					//	since it was queued
+					if (task.Prioritize) {
+					
+						auto priority=task.Prioritize();
+						
+						//	Stale, drop it
+						if (priority.IsNull()) {
+						
+							dropped.Add(std::move(task));
+							
+							continue;
+						
+						}
+						
+						//	If the task no longer belongs at
+						//	the front of the queue, put it
+						//	back and try again
+						task.Current=*priority;
+						if (
+							(pending.Count()!=0) &&
+							compare(task,pending[0])
+						) {
+						
+							push(std::move(task));
+							
+							continue;
+						
+						}
+					
+					}
+					
+					pool.Enqueue(std::move(task.Callback));
+					
+					return;
+				
+				}
+				
+				--running;
+			
+			} catch (...) {
+			
+				--running;
+			
+				try {
+				
+					panic();
+				
+				} catch (...) {	}
+			
+			}
+		
+		});
+	
+	}
+	
+	
+	void ConcurrencyManager::enqueue (std::function<void ()> callback, Priority priority) {
+	
+		Task task;
+		task.Current=0;
+		if (priority) {
+		
+			auto current=priority();
+			
+			//	Stale before it was even enqueued
+			if (current.IsNull()) return;
+			
+			task.Current=*current;
+		
+		}
+		task.Prioritize=std::move(priority);
+		task.Callback=std::move(callback);
+		
+		lock.Execute([&] () mutable {
+		
+			if (running<max) {
+			
+				pool.Enqueue(std::move(task.Callback));
+				
+				++running;
+			
+			} else {
+			
+				task.Sequence=sequence++;
+				
+				push(std::move(task));
+			
+			}
+		
+		});
+	
+	}
+	
+	
+	void ConcurrencyManager::Reprioritize () {
+	
+		//	Stale tasks are destroyed once the lock
+		//	is released, since destroying them may
+		//	run arbitrary code
+		Vector<Task> dropped;
+	
+		lock.Execute([&] () {
+		
+			Vector<Task> tasks(pending.Count());
+			dropped=Vector<Task>(pending.Count());
+			for (auto & task : pending) {
+			
+				if (task.Prioritize) {
+				
+					auto priority=task.Prioritize();
+					if (priority.IsNull()) {
+					
+						dropped.Add(std::move(task));
+						
+						continue;
+					
+					}
+					
+					task.Current=*priority;
+				
+				}
+				
+				tasks.Add(std::move(task));
+			
+			}
+			
+			std::make_heap(tasks.begin(),tasks.end(),compare);
+			pending=std::move(tasks);
+		
+		});
+	
+	}
+	
+	
 	Word ConcurrencyManager::Maximum () const noexcept {
 	
 		return max;
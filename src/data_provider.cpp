@@ -10,6 +10,142 @@ namespace MCPP {
 	DataProvider::~DataProvider () noexcept {	}
 	
 	
+	constexpr Byte ColumnKey::Header;
+	
+	
+	static const String column_key_template("column_{0}_{1}_{2}");
+	static const String section_key_template("column_{0}_{1}_{2}_{3}");
+	
+	
+	//	Columns stored through the binary store
+	//	use the same keys as before the column
+	//	store existed, so that existing worlds
+	//	may still be loaded
+	String DataProvider::GetBinaryKey (const ColumnKey & key) {
+	
+		if (key.Section==ColumnKey::Header) return String::Format(
+			column_key_template,
+			key.X,
+			key.Z,
+			key.Dimension
+		);
+		
+		return String::Format(
+			section_key_template,
+			key.X,
+			key.Z,
+			key.Dimension,
+			static_cast<Word>(key.Section)
+		);
+	
+	}
+	
+	
+	Nullable<Vector<Byte>> DataProvider::GetColumn (const ColumnKey & key) {
+	
+		return GetBinary(GetBinaryKey(key));
+	
+	}
+	
+	
+	void DataProvider::SaveColumn (const ColumnKey & key, const void * ptr, Word len) {
+	
+		SaveBinary(GetBinaryKey(key),ptr,len);
+	
+	}
+	
+	
+	void DataProvider::DeleteColumn (const ColumnKey & key) {
+	
+		DeleteBinary(GetBinaryKey(key));
+	
+	}
+	
+	
+	Vector<Nullable<Vector<Byte>>> DataProvider::GetColumns (const Vector<ColumnKey> & keys) {
+	
+		Vector<Nullable<Vector<Byte>>> retr(keys.Count());
+		for (const auto & key : keys) retr.Add(GetColumn(key));
+		
+		return retr;
+	
+	}
+	
+	
+	//	Invokes a callback synchronously, and
+	//	returns a promise which is fulfilled or
+	//	broken by its result
+	template <typename T, typename Callback>
+	static Promise<T> synchronous (Callback && callback) {
+	
+		Promise<T> retr;
+		
+		//	Any exception breaks the promise
+		try {
+		
+			retr.Execute(std::forward<Callback>(callback));
+		
+		} catch (...) {	}
+		
+		return retr;
+	
+	}
+	
+	
+	void DataProvider::SaveColumns (const Vector<ColumnData> & data) {
+	
+		for (const auto & d : data) {
+		
+			if (d.Pointer==nullptr) DeleteColumn(d.Key);
+			else SaveColumn(d.Key,d.Pointer,d.Length);
+		
+		}
+	
+	}
+	
+	
+	Promise<Nullable<Vector<Byte>>> DataProvider::GetBinaryAsync (String key) {
+	
+		return synchronous<Nullable<Vector<Byte>>>([&] () {	return GetBinary(key);	});
+	
+	}
+	
+	
+	Promise<void> DataProvider::SaveBinaryAsync (String key, Vector<Byte> buffer) {
+	
+		return synchronous<void>([&] () {	SaveBinary(key,buffer.begin(),buffer.Count());	});
+	
+	}
+	
+	
+	Promise<void> DataProvider::DeleteBinaryAsync (String key) {
+	
+		return synchronous<void>([&] () {	DeleteBinary(key);	});
+	
+	}
+	
+	
+	Promise<Nullable<Vector<Byte>>> DataProvider::GetColumnAsync (ColumnKey key) {
+	
+		return synchronous<Nullable<Vector<Byte>>>([&] () {	return GetColumn(key);	});
+	
+	}
+	
+	
+	Promise<Vector<Nullable<Vector<Byte>>>> DataProvider::GetColumnsAsync (Vector<ColumnKey> keys) {
+	
+		return synchronous<Vector<Nullable<Vector<Byte>>>>([&] () {	return GetColumns(keys);	});
+	
+	}
+	
+	
+	Promise<void> DataProvider::SaveColumnsAsync (Vector<ColumnData> data) {
+	
+		return synchronous<void>([&] () {	SaveColumns(data);	});
+	
+	}
+	
+	
 	static const String success("Success");
 	static const String error("Error");
 	static const String information("Information");
@@ -1098,7 +1098,7 @@ class DefaultGenerator : public WorldGenerator {
 					//	bedrock
 					if (y==0) {
 					
-						column.Blocks[offset++]=bedrock;
+						column.Write(offset++,bedrock);
 						
 						continue;
 						
@@ -1227,10 +1227,7 @@ class DefaultGenerator : public WorldGenerator {
 								)
 					);
 					
-					block.SetSkylight(15);
-					block.SetLight(15);
-					
-					column.Blocks[offset++]=block;
+					column.Write(offset++,block);
 					
 					//	Set biome if this is the
 					//	last block in this column
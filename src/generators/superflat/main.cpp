@@ -201,7 +201,7 @@ class SuperFlatGenerator : public Module, public WorldGenerator {
 	
 		//	A template of the column that
 		//	will be repeatedly "generated"
-		//	via memcpy
+		//	by copying
 		Block blocks [16*16*16*16];
 		//	The biome that will be set on
 		//	all columns
@@ -309,21 +309,13 @@ class SuperFlatGenerator : public Module, public WorldGenerator {
 		
 		virtual void operator () (ColumnContainer & column) const override {
 		
-			//	Ensure that the copy operation
-			//	is safe
-			static_assert(
-				(sizeof(column.Blocks)==sizeof(blocks)),
-				"Layout incompatible"
-			);
-		
 			//	Since all superflat generated
 			//	columns are identical, we just
-			//	have to memcpy
-			std::memcpy(
-				column.Blocks,
-				blocks,
-				sizeof(column.Blocks)
-			);
+			//	have to copy the template
+			//
+			//	Sections of the template which
+			//	are entirely air are not allocated
+			for (Word i=0;i<(16*16*16*16);++i) column.Write(i,blocks[i]);
 			
 			//	Loop and set all biomes
 			for (auto & b : column.Biomes) b=biome;
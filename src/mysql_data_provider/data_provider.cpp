@@ -12,6 +12,14 @@ namespace MCPP {
 		DataProvider::LogEntry::LogEntry (String text, Service::LogType type) noexcept : Text(std::move(text)), Type(type) {	}
 		
 		
+		DataProvider::ChatLogEntry::ChatLogEntry (String from, Nullable<String> to, String message, Nullable<String> notes) noexcept
+			:	From(std::move(from)),
+				To(std::move(to)),
+				Message(std::move(message)),
+				Notes(std::move(notes))
+		{	}
+		
+		
 		template <typename T, typename... Args>
 		auto DataProvider::prepare (Connection & conn, T && callback, Args &&... args) -> decltype(
 			callback(std::forward<Args>(args)...)
@@ -90,16 +98,163 @@ namespace MCPP {
 		}
 		
 		
-		static const String log_query("INSERT INTO `log` (`text`,`type`) VALUES (?,?)");
+		//	The maximum number of rows inserted
+		//	by a single statement, this bounds
+		//	the number of distinct statements
+		//	each connection prepares
+		static const Word max_rows=32;
+		static const String row_separator(",");
 		
 		
-		void DataProvider::write_log (const String & text, Service::LogType type) {
+		//	Builds a statement which inserts a
+		//	certain number of rows
+		static String insert_query (const String & begin, const String & row, Word rows) {
 		
-			perform(
-				log_query,
-				text,
-				MCPP::DataProvider::GetLogType(type)
-			);
+			String retr(begin);
+			for (Word i=0;i<rows;++i) {
+			
+				if (i!=0) retr << row_separator;
+				retr << row;
+			
+			}
+			
+			return retr;
+		
+		}
+		
+		
+		//	The number of queued log entries at
+		//	which the logging thread writes a
+		//	batch
+		static const Word batch_size=64;
+		//	The longest time, in milliseconds, a
+		//	log entry is queued before the logging
+		//	thread writes it
+		static const UInt64 max_age=250;
+		//	The number of queued log entries at
+		//	which callers wait for the logging
+		//	thread
+		static const Word max_queued=4096;
+		
+		
+		Word DataProvider::queued () const noexcept {
+		
+			return log.Count()+chat_log.Count();
+		
+		}
+		
+		
+		//	Must be called while the lock is held,
+		//	immediately before an entry is queued
+		void DataProvider::enqueue () {
+		
+			//	Apply backpressure if the logging
+			//	thread has fallen too far behind
+			while (!stop && (queued()>=max_queued)) space.Sleep(lock);
+			
+			Word count=queued();
+			if (count==0) oldest=timer.ElapsedMilliseconds();
+			
+			//	The logging thread only has to be woken
+			//	when the first entry is queued, or when
+			//	a batch is full, otherwise it's waiting
+			//	for the oldest entry to age
+			if ((count==0) || ((count+1)==batch_size)) wait.Wake();
+		
+		}
+		
+		
+		static const String log_query_begin("INSERT INTO `log` (`text`,`type`) VALUES ");
+		static const String log_query_row("(?,?)");
+		
+		
+		void DataProvider::write_log (Vector<LogEntry> & entries) {
+		
+			prepare(log_connection,[&] () {
+			
+				for (Word i=0;i<entries.Count();i+=max_rows) {
+				
+					Word rows=entries.Count()-i;
+					if (rows>max_rows) rows=max_rows;
+					
+					//	Binds refer to buffers owned by
+					//	binders, so binders must not move
+					//	once binding has begun
+					Vector<Binder<String>> binders(rows*2);
+					Vector<MYSQL_BIND> binds(rows*2);
+					for (Word n=i;n<(i+rows);++n) {
+					
+						auto & entry=entries[n];
+						
+						MYSQL_BIND row [2];
+						std::memset(row,0,sizeof(row));
+						
+						binders.EmplaceBack();
+						binders[binders.Count()-1].Initialize(row[0],entry.Text);
+						binders.EmplaceBack();
+						binders[binders.Count()-1].Initialize(row[1],MCPP::DataProvider::GetLogType(entry.Type));
+						
+						for (auto & bind : row) binds.Add(bind);
+					
+					}
+					
+					auto & stmt=log_connection.Get(insert_query(log_query_begin,log_query_row,rows));
+					stmt.Parameters(binds.begin());
+					stmt.Execute();
+				
+				}
+			
+			});
+		
+		}
+		
+		
+		static const String chat_log_query_begin("INSERT INTO `chat_log` (`from`,`to`,`message`,`notes`) VALUES ");
+		static const String chat_log_query_row("(?,?,?,?)");
+		
+		
+		void DataProvider::write_chat_log (Vector<ChatLogEntry> & entries) {
+		
+			prepare(log_connection,[&] () {
+			
+				for (Word i=0;i<entries.Count();i+=max_rows) {
+				
+					Word rows=entries.Count()-i;
+					if (rows>max_rows) rows=max_rows;
+					
+					//	Binds refer to buffers owned by
+					//	binders, so binders must not move
+					//	once binding has begun
+					Vector<Binder<String>> binders(rows*2);
+					Vector<Binder<Nullable<String>>> nullable_binders(rows*2);
+					Vector<MYSQL_BIND> binds(rows*4);
+					for (Word n=i;n<(i+rows);++n) {
+					
+						auto & entry=entries[n];
+						
+						MYSQL_BIND row [4];
+						std::memset(row,0,sizeof(row));
+						
+						binders.EmplaceBack();
+						binders[binders.Count()-1].Initialize(row[0],entry.From);
+						nullable_binders.EmplaceBack();
+						nullable_binders[nullable_binders.Count()-1].Initialize(row[1],entry.To);
+						binders.EmplaceBack();
+						binders[binders.Count()-1].Initialize(row[2],entry.Message);
+						nullable_binders.EmplaceBack();
+						nullable_binders[nullable_binders.Count()-1].Initialize(row[3],entry.Notes);
+						
+						for (auto & bind : row) binds.Add(bind);
+					
+					}
+					
+					auto & stmt=log_connection.Get(insert_query(chat_log_query_begin,chat_log_query_row,rows));
+					stmt.Parameters(binds.begin());
+					stmt.Execute();
+				
+				}
+			
+			});
 		
 		}
 	
@@ -110,27 +265,45 @@ namespace MCPP {
 			
 				for (;;) {
 				
-					auto entry=lock.Execute([&] () {
+					Vector<LogEntry> log;
+					Vector<ChatLogEntry> chat_log;
 					
-						while ((log.Count()==0) && !stop) wait.Sleep(lock);
+					if (!lock.Execute([&] () {
+					
+						//	Wait for there to be something
+						//	to do
+						while ((queued()==0) && !stop) wait.Sleep(lock);
 						
-						Nullable<LogEntry> entry;
+						//	Wait for a batch to fill, or for
+						//	the oldest entry to have waited
+						//	long enough
+						UInt64 elapsed;
+						while (
+							!stop &&
+							(queued()<batch_size) &&
+							((elapsed=timer.ElapsedMilliseconds()-oldest)<max_age)
+						) wait.Sleep(
+							lock,
+							static_cast<Word>(max_age-elapsed)
+						);
 						
-						if (log.Count()==0) return entry;
+						//	Only happens if we're to
+						//	stop
+						if (queued()==0) return false;
 						
-						entry.Construct(std::move(log[0]));
-						log.Delete(0);
+						log=std::move(this->log);
+						this->log=Vector<LogEntry>();
+						chat_log=std::move(this->chat_log);
+						this->chat_log=Vector<ChatLogEntry>();
 						
-						return entry;
-					
-					});
+						space.WakeAll();
+						
+						return true;
 					
-					if (entry.IsNull()) break;
+					})) break;
 					
-					write_log(
-						entry->Text,
-						entry->Type
-					);
+					write_log(log);
+					write_chat_log(chat_log);
 				
 				}
 			
@@ -195,8 +368,17 @@ namespace MCPP {
 			Nullable<String> password,
 			Nullable<String> database,
 			Nullable<UInt16> port,
-			Word max
-		)	:	stop(false),
+			Word max,
+			Word io_threads
+		)	:	timer(Timer::CreateAndStart()),
+				stop(false),
+				log_connection(
+					host,
+					username,
+					password,
+					database,
+					port
+				),
 				pool(
 					ConnectionFactory(
 						std::move(host),
@@ -206,13 +388,15 @@ namespace MCPP {
 						std::move(port)
 					),
 					max
-				)
+				),
+				io(io_threads)
 		{
 		
 			connecting=0;
 			connected=0;
 			executing=0;
 			executed=0;
+			legacy=legacy_unknown;
 		
 			thread=Thread([this] () mutable {	worker();	});
 		
@@ -226,6 +410,7 @@ namespace MCPP {
 				stop=true;
 				
 				wait.WakeAll();
+				space.WakeAll();
 			
 			});
 			
@@ -354,9 +539,9 @@ namespace MCPP {
 		
 			lock.Execute([&] () {
 			
-				log.EmplaceBack(text,type);
+				enqueue();
 				
-				wait.Wake();
+				log.EmplaceBack(text,type);
 			
 			});
 		
@@ -364,7 +549,6 @@ namespace MCPP {
 		
 		
 		static const String to_separator(", ");
-		static const String chat_log_query("INSERT INTO `chat_log` (`from`,`to`,`message`,`notes`) VALUES (?,?,?,?)");
 		
 		
 		void DataProvider::WriteChatLog (const String & from, const Vector<String> & to, const String & message, const Nullable<String> & notes) {
@@ -380,13 +564,18 @@ namespace MCPP {
 			
 			}
 			
-			perform(
-				chat_log_query,
-				from,
-				to_str,
-				message,
-				notes
-			);
+			lock.Execute([&] () {
+			
+				enqueue();
+				
+				chat_log.EmplaceBack(
+					from,
+					std::move(to_str),
+					message,
+					notes
+				);
+			
+			});
 		
 		}
 		
@@ -473,6 +662,413 @@ namespace MCPP {
 		}
 		
 		
+		static const Word legacy_unknown=0;
+		static const Word legacy_present=1;
+		static const Word legacy_absent=2;
+		static const String legacy_columns_query("SELECT 1 FROM `binary` WHERE `key` LIKE 'column\\_%' LIMIT 1");
+		
+		
+		bool DataProvider::has_legacy_columns () {
+		
+			Word state=legacy;
+			if (state!=legacy_unknown) return state==legacy_present;
+			
+			auto result=MakeBind(Output<Int32>{});
+			
+			bool present=execute([&] (Connection & conn) {
+			
+				auto & stmt=conn.Get(legacy_columns_query);
+				
+				stmt.Results(result);
+				stmt.Execute();
+				
+				if (!stmt.Fetch()) return false;
+				
+				stmt.Complete();
+				
+				return true;
+			
+			});
+			
+			//	Columns are never saved to the binary
+			//	store by this data provider, so once
+			//	they're absent they remain absent
+			legacy=present ? legacy_present : legacy_absent;
+			
+			return present;
+		
+		}
+		
+		
+		static const String get_legacy_columns_query_begin("SELECT `key`,`value` FROM `binary` WHERE `key` IN (");
+		static const String get_legacy_columns_query_row("?");
+		static const String get_legacy_columns_query_end(")");
+		
+		
+		void DataProvider::get_legacy_columns (const Vector<ColumnKey> & keys, Vector<Nullable<Vector<Byte>>> & retr) {
+		
+			//	Keys which were not found, and their
+			//	keys in the binary store
+			Vector<Word> missing;
+			Vector<String> names;
+			for (Word i=0;i<keys.Count();++i) if (retr[i].IsNull()) {
+			
+				missing.Add(i);
+				names.Add(GetBinaryKey(keys[i]));
+			
+			}
+			
+			if ((missing.Count()==0) || !has_legacy_columns()) return;
+			
+			execute([&] (Connection & conn) {
+			
+				for (Word i=0;i<missing.Count();i+=max_rows) {
+				
+					Word rows=missing.Count()-i;
+					if (rows>max_rows) rows=max_rows;
+					
+					//	Binds refer to buffers owned by
+					//	binders, so binders must not move
+					//	once binding has begun
+					Vector<Binder<String>> binders(rows);
+					Vector<MYSQL_BIND> binds(rows);
+					for (Word n=i;n<(i+rows);++n) {
+					
+						MYSQL_BIND bind;
+						std::memset(&bind,0,sizeof(bind));
+						
+						binders.EmplaceBack();
+						binders[binders.Count()-1].Initialize(bind,names[n]);
+						
+						binds.Add(bind);
+					
+					}
+					
+					auto query=insert_query(get_legacy_columns_query_begin,get_legacy_columns_query_row,rows);
+					query << get_legacy_columns_query_end;
+					
+					auto result=MakeBind(Output<String>{},Output<Vector<Byte>>{});
+					
+					auto & stmt=conn.Get(query);
+					stmt.Parameters(binds.begin());
+					stmt.Results(result);
+					stmt.Execute();
+					
+					while (stmt.Fetch()) {
+					
+						auto name=result.Get<0>(stmt);
+						auto value=result.Get<1>(stmt);
+						for (Word n=i;n<(i+rows);++n) if (names[n]==name) retr[missing[n]]=value;
+					
+					}
+				
+				}
+			
+			});
+		
+		}
+		
+		
+		static const String get_column_query("SELECT `value` FROM `columns` WHERE `x`=? AND `z`=? AND `dimension`=? AND `section`=?");
+		
+		
+		Nullable<Vector<Byte>> DataProvider::GetColumn (const ColumnKey & key) {
+		
+			Int32 x=key.X;
+			Int32 z=key.Z;
+			SByte dimension=key.Dimension;
+			Byte section=key.Section;
+			auto param=MakeBind(x,z,dimension,section);
+			auto result=MakeBind(Output<Nullable<Vector<Byte>>>{});
+			
+			auto retr=execute([&] (Connection & conn) {
+			
+				auto & stmt=conn.Get(get_column_query);
+				
+				stmt.Parameters(param);
+				stmt.Results(result);
+				stmt.Execute();
+				
+				if (!stmt.Fetch()) return Nullable<Vector<Byte>>{};
+				
+				auto retr=result.Get(stmt);
+				
+				stmt.Complete();
+				
+				return retr;
+			
+			});
+			
+			//	Columns saved before the column
+			//	table existed are in the binary
+			//	store
+			if (retr.IsNull() && has_legacy_columns()) return MCPP::DataProvider::GetColumn(key);
+			
+			return retr;
+		
+		}
+		
+		
+		static const String save_column_query("REPLACE INTO `columns` (`x`,`z`,`dimension`,`section`,`value`) VALUES (?,?,?,?,?)");
+		
+		
+		void DataProvider::SaveColumn (const ColumnKey & key, const void * ptr, Word len) {
+		
+			Int32 x=key.X;
+			Int32 z=key.Z;
+			SByte dimension=key.Dimension;
+			Byte section=key.Section;
+			Blob blob(ptr,len);
+			perform(save_column_query,x,z,dimension,section,blob);
+		
+		}
+		
+		
+		static const String delete_column_query("DELETE FROM `columns` WHERE `x`=? AND `z`=? AND `dimension`=? AND `section`=?");
+		
+		
+		void DataProvider::DeleteColumn (const ColumnKey & key) {
+		
+			Int32 x=key.X;
+			Int32 z=key.Z;
+			SByte dimension=key.Dimension;
+			Byte section=key.Section;
+			perform(delete_column_query,x,z,dimension,section);
+		
+		}
+		
+		
+		static bool is_same_column (const ColumnKey & a, const ColumnKey & b) noexcept {
+		
+			return (a.X==b.X) && (a.Z==b.Z) && (a.Dimension==b.Dimension);
+		
+		}
+		
+		
+		static const String sections_separator(",");
+		static const String get_columns_query("SELECT `section`,`value` FROM `columns` WHERE `x`=? AND `z`=? AND `dimension`=? AND FIND_IN_SET(`section`,?)");
+		
+		
+		Vector<Nullable<Vector<Byte>>> DataProvider::GetColumns (const Vector<ColumnKey> & keys) {
+		
+			Vector<Nullable<Vector<Byte>>> retr(keys.Count());
+			for (Word i=0;i<keys.Count();++i) retr.EmplaceBack();
+			if (keys.Count()==0) return retr;
+			
+			//	Whether each key has been fetched
+			Vector<bool> fetched(keys.Count());
+			for (Word i=0;i<keys.Count();++i) fetched.Add(false);
+			
+			execute([&] (Connection & conn) {
+			
+				auto & stmt=conn.Get(get_columns_query);
+			
+				//	Each column's pieces are fetched
+				//	with a single statement
+				for (Word i=0;i<keys.Count();++i) {
+				
+					if (fetched[i]) continue;
+					
+					const auto & key=keys[i];
+					Int32 x=key.X;
+					Int32 z=key.Z;
+					SByte dimension=key.Dimension;
+					String sections;
+					for (Word n=i;n<keys.Count();++n) if (is_same_column(key,keys[n])) {
+					
+						if (sections.Size()!=0) sections << sections_separator;
+						sections << String(static_cast<Word>(keys[n].Section));
+						
+						fetched[n]=true;
+					
+					}
+					
+					auto param=MakeBind(x,z,dimension,sections);
+					auto result=MakeBind(Output<Byte>{},Output<Vector<Byte>>{});
+					
+					stmt.Parameters(param);
+					stmt.Results(result);
+					stmt.Execute();
+					
+					while (stmt.Fetch()) {
+					
+						auto section=result.Get<0>(stmt);
+						auto value=result.Get<1>(stmt);
+						for (Word n=i;n<keys.Count();++n) if (
+							is_same_column(key,keys[n]) &&
+							(keys[n].Section==section)
+						) retr[n]=value;
+					
+					}
+				
+				}
+			
+			});
+			
+			//	Columns saved before the column
+			//	table existed are in the binary
+			//	store
+			get_legacy_columns(keys,retr);
+			
+			return retr;
+		
+		}
+		
+		
+		static const String save_columns_query_begin("REPLACE INTO `columns` (`x`,`z`,`dimension`,`section`,`value`) VALUES ");
+		static const String save_columns_query_row("(?,?,?,?,?)");
+		static const String delete_columns_query("DELETE FROM `columns` WHERE `x`=? AND `z`=? AND `dimension`=? AND FIND_IN_SET(`section`,?)");
+		
+		
+		void DataProvider::SaveColumns (const Vector<ColumnData> & data) {
+		
+			if (data.Count()==0) return;
+		
+			//	Binds refer to these, so they must
+			//	not move once binding has begun
+			Vector<ColumnKey> keys(data.Count());
+			Vector<Blob> blobs(data.Count());
+			for (const auto & d : data) if (d.Pointer!=nullptr) {
+			
+				keys.Add(d.Key);
+				blobs.EmplaceBack(d.Pointer,d.Length);
+			
+			}
+			
+			//	Whether each deletion has been
+			//	performed
+			Vector<bool> deleted(data.Count());
+			for (const auto & d : data) deleted.Add(d.Pointer!=nullptr);
+			
+			execute([&] (Connection & conn) {
+			
+				//	Each column's deleted pieces are
+				//	deleted with a single statement
+				for (Word i=0;i<data.Count();++i) {
+				
+					if (deleted[i]) continue;
+					
+					const auto & key=data[i].Key;
+					Int32 x=key.X;
+					Int32 z=key.Z;
+					SByte dimension=key.Dimension;
+					String sections;
+					for (Word n=i;n<data.Count();++n) if (
+						!deleted[n] &&
+						is_same_column(key,data[n].Key)
+					) {
+					
+						if (sections.Size()!=0) sections << sections_separator;
+						sections << String(static_cast<Word>(data[n].Key.Section));
+						
+						deleted[n]=true;
+					
+					}
+					
+					auto param=MakeBind(x,z,dimension,sections);
+					auto & stmt=conn.Get(delete_columns_query);
+					stmt.Parameters(param);
+					stmt.Execute();
+				
+				}
+				
+				//	Saved pieces are saved in batches
+				//	of up to max_rows rows
+				Vector<MYSQL_BIND> binds;
+				for (Word i=0;i<keys.Count();i+=max_rows) {
+				
+					Word rows=keys.Count()-i;
+					if (rows>max_rows) rows=max_rows;
+					
+					auto query=insert_query(save_columns_query_begin,save_columns_query_row,rows);
+					
+					binds.Clear();
+					binds.SetCapacity(rows*5);
+					for (Word n=i;n<(i+rows);++n) {
+					
+						MYSQL_BIND row [5];
+						std::memset(row,0,sizeof(row));
+						
+						auto & key=keys[n];
+						Binder<Int32>().Initialize(row[0],key.X);
+						Binder<Int32>().Initialize(row[1],key.Z);
+						Binder<SByte>().Initialize(row[2],key.Dimension);
+						Binder<Byte>().Initialize(row[3],key.Section);
+						Binder<Blob>().Initialize(row[4],blobs[n]);
+						
+						for (auto & bind : row) binds.Add(bind);
+					
+					}
+					
+					auto & stmt=conn.Get(query);
+					stmt.Parameters(binds.begin());
+					stmt.Execute();
+				
+				}
+			
+			});
+		
+		}
+		
+		
+		Promise<Nullable<Vector<Byte>>> DataProvider::GetBinaryAsync (String key) {
+		
+			return io.Enqueue(
+				[this] (const String & key) {	return GetBinary(key);	},
+				std::move(key)
+			);
+		
+		}
+		
+		
+		Promise<void> DataProvider::SaveBinaryAsync (String key, Vector<Byte> buffer) {
+		
+			return io.Enqueue(
+				[this] (const String & key, const Vector<Byte> & buffer) {	SaveBinary(key,buffer.begin(),buffer.Count());	},
+				std::move(key),
+				std::move(buffer)
+			);
+		
+		}
+		
+		
+		Promise<void> DataProvider::DeleteBinaryAsync (String key) {
+		
+			return io.Enqueue(
+				[this] (const String & key) {	DeleteBinary(key);	},
+				std::move(key)
+			);
+		
+		}
+		
+		
+		Promise<Nullable<Vector<Byte>>> DataProvider::GetColumnAsync (ColumnKey key) {
+		
+			return io.Enqueue([this,key] () {	return GetColumn(key);	});
+		
+		}
+		
+		
+		Promise<Vector<Nullable<Vector<Byte>>>> DataProvider::GetColumnsAsync (Vector<ColumnKey> keys) {
+		
+			return io.Enqueue(
+				[this] (const Vector<ColumnKey> & keys) {	return GetColumns(keys);	},
+				std::move(keys)
+			);
+		
+		}
+		
+		
+		Promise<void> DataProvider::SaveColumnsAsync (Vector<ColumnData> data) {
+		
+			return io.Enqueue(
+				[this] (const Vector<ColumnData> & data) {	SaveColumns(data);	},
+				std::move(data)
+			);
+		
+		}
+		
+		
 		static const String retrieve_setting_query("SELECT `value` FROM `settings` WHERE `setting`=?");
 		
 		
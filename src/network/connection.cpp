@@ -34,6 +34,13 @@ namespace MCPP {
 		return received;
 	
 	}
+	
+	
+	Word Connection::Queued () const noexcept {
+	
+		return queued;
+	
+	}
 
 
 }
@@ -28,6 +28,7 @@ namespace MCPP {
 			//	Fail all promises
 			for (auto & send : sends) send.Completion.Complete(false);
 			sends.Clear();
+			queued=0;
 			
 			//	Tell the worker thread to update this
 			//	file descriptor unless we're running in
@@ -222,6 +223,7 @@ namespace MCPP {
 				//	Advance the sent count
 				auto num=static_cast<Word>(result);
 				sent+=num;
+				queued-=num;
 				f.Sent+=num;
 				s.Sent+=num;
 				
@@ -484,6 +486,7 @@ namespace MCPP {
 		pending_recv=false;
 		sent=0;
 		received=0;
+		queued=0;
 	
 	}
 	
@@ -504,6 +507,7 @@ namespace MCPP {
 		pending_recv=false;
 		sent=0;
 		received=0;
+		queued=0;
 	
 	}
 	
@@ -567,7 +571,9 @@ namespace MCPP {
 			
 			//	Add to send queue
 			auto promise=send.Completion;
+			Word count=send.Buffer.Count();
 			sends.Add(std::move(send));
+			queued+=count;
 			
 			return promise;
 		
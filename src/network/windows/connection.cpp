@@ -19,6 +19,7 @@ namespace MCPP {
 			
 			//	Fail all remaining receives
 			for (auto & pair : sends) pair.second->Completion.Complete(false);
+			queued=0;
 			
 			return true;
 		
@@ -193,6 +194,8 @@ namespace MCPP {
 				
 				sends.erase(iter);
 				
+				queued-=retr->Buffer.Count();
+				
 				return retr;
 			
 			});
@@ -350,6 +353,7 @@ namespace MCPP {
 	
 		sent=0;
 		received=0;
+		queued=0;
 		pending=1;
 	
 	}
@@ -412,6 +416,8 @@ namespace MCPP {
 				ptr,
 				std::move(command)
 			);
+			Word count=ptr->Buffer.Count();
+			queued+=count;
 			
 			//	Send
 			auto result=ptr->Dispatch(socket);
@@ -422,6 +428,7 @@ namespace MCPP {
 				//	Make sure we roll back the insertion
 				//	of the send
 				sends.erase(pair.first);
+				queued-=count;
 				
 				try {
 				
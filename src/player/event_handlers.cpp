@@ -1,13 +1,19 @@
 #include <player/player.hpp>
 #include <entity_id/entity_id.hpp>
 #include <server.hpp>
-#include <utility>
 #include <limits>
+#include <new>
+#include <utility>
 
 
 namespace MCPP {
 
 
+	//	The height of a player's eyes above
+	//	their feet
+	static const Double stance_offset=1.62;
+	
+	
 	void Players::on_connect (SmartPointer<Client> client) {
 	
 		players_lock.Write([&] () {
@@ -24,7 +30,27 @@ namespace MCPP {
 	
 	void Players::on_disconnect (SmartPointer<Client> client, const String &) {
 	
-		players_lock.Write([&] () {	players.erase(client);	});
+		SmartPointer<Player> player;
+		players_lock.Write([&] () {
+		
+			auto iter=players.find(client);
+			if (iter==players.end()) return;
+			
+			player=std::move(iter->second);
+			players.erase(iter);
+		
+		});
+		
+		if (player.IsNull()) return;
+		
+		//	Position updates and prefetches may be
+		//	queued, and hold the player, stop them
+		//	from acquiring interest on a departed
+		//	player's behalf, then cancel prefetches
+		//	which were already dispatched
+		player->Lock.Execute([&] () {	player->Disconnected=true;	});
+		
+		end_prefetch(*player);
 	
 	}
 	
@@ -51,9 +77,24 @@ namespace MCPP {
 		//	position/other information
 		//	from backing store
 		
-		//	TODO: Manipulate spawn_y so that
-		//	the player always spawns in air,
-		//	but right above ground
+		//	The player always spawns in air,
+		//	but right above ground.
+		//
+		//	Waiting for the spawn column to be
+		//	loaded, generated, and populated would
+		//	block this thread, so if it hasn't been
+		//	generated the configured spawn height is
+		//	used instead
+		auto height=World::Get().Begin(
+			BlockWriteStrategy::Dirty,
+			BlockAccessStrategy::Generated
+		).GetHeight(
+			spawn_x,
+			spawn_z,
+			dimension,
+			std::nothrow
+		);
+		if (!height.IsNull()) spawn_y=static_cast<Int32>(*height);
 		
 		//	Setup this player's object
 		auto player=SmartPointer<Player>::Make();
@@ -64,8 +105,17 @@ namespace MCPP {
 		player->Position.Z=spawn_z;	//	TEMP
 		player->Position.Yaw=0;	//	TEMP
 		player->Position.Pitch=0;	//	TEMP
-		player->Position.Stance=74;	//	TEMP
+		player->Position.Stance=spawn_y+stance_offset;
 		player->Dimension=dimension;
+		player->PrefetchFrom=ColumnID::GetContaining(
+			player->Position.X,
+			player->Position.Z,
+			dimension
+		);
+		player->HeadingX=0;
+		player->HeadingZ=0;
+		player->Lookahead=0;
+		player->Disconnected=false;
 		
 		//	Add to list of players before
 		//	send
@@ -119,11 +169,26 @@ namespace MCPP {
 		if (player.IsNull()) return;
 		
 		//	Update player's position
-		auto t=player->Lock.Execute([&] () {	return player->Position.FromPacket(event.Data);	});
+		bool turned;
+		auto t=player->Lock.Execute([&] () {
+		
+			auto retr=player->Position.FromPacket(event.Data);
+			
+			auto h=heading(player->Position);
+			turned=(
+				(h.Item<0>()!=player->HeadingX) ||
+				(h.Item<1>()!=player->HeadingZ) ||
+				(h.Item<2>()!=player->Lookahead)
+			);
+			
+			return retr;
+		
+		});
 		
-		//	If the player moved, update
-		//	their position
-		if (t.Item<0>()!=0) {
+		//	If the player moved, or their
+		//	heading changed, update their
+		//	position
+		if ((t.Item<0>()!=0) || turned) {
 		
 			Server::Get().Pool().Enqueue([=] () mutable {	update_position(player);	});
 			
@@ -13,6 +13,10 @@ namespace MCPP {
 			column,
 			true
 		);
+		
+		//	Release any interest acquired by
+		//	prefetching
+		for (auto & pair : Prefetched) if (pair.second) World::Get().EndInterest(pair.first);
 	
 	}
 
@@ -6,7 +6,17 @@
 namespace MCPP {
 
 
-	PlayerPosition::PlayerPosition (bool on_ground) noexcept : on_ground(on_ground) {
+	//	The weight given to each new sample
+	//	when smoothing velocity
+	static const Double smoothing=0.25;
+	//	Packets further apart than this (in
+	//	nanoseconds) do not contribute to
+	//	velocity, the player was not moving
+	//	continuously between them
+	static const UInt64 max_sample=1000000000ULL;
+	
+	
+	PlayerPosition::PlayerPosition (bool on_ground) noexcept : on_ground(on_ground), VelocityX(0), VelocityZ(0) {
 	
 		if (!on_ground) on_ground_timer=Timer::CreateAndStart();
 		last_packet_timer=Timer::CreateAndStart();
@@ -14,6 +24,9 @@ namespace MCPP {
 	}
 	
 	
+	PlayerPosition::PlayerPosition () noexcept : PlayerPosition(true) {	}
+	
+	
 	PlayerPosition::PlayerPosition (Double x, Double y, Double z, Double stance, bool on_ground) noexcept : PlayerPosition(on_ground) {
 	
 		X=x;
@@ -121,7 +134,7 @@ namespace MCPP {
 				auto & pa=packet.Get<pp>();
 				
 				X=pa.X;
-				Y=pa.X;
+				Y=pa.Y;
 				Stance=pa.Stance;
 				Z=pa.Z;
 				time=SetOnGround(pa.OnGround);
@@ -154,6 +167,19 @@ namespace MCPP {
 		
 		}
 		
+		//	Update velocity.  Packets without a
+		//	position count as samples where the
+		//	player did not move, so that velocity
+		//	decays once the player stops
+		if ((last!=0) && (last<=max_sample)) {
+		
+			Double seconds=static_cast<Double>(last)/1000000000.0;
+			
+			VelocityX=fma(smoothing,((X-x)/seconds)-VelocityX,VelocityX);
+			VelocityZ=fma(smoothing,((Z-z)/seconds)-VelocityZ,VelocityZ);
+		
+		}
+		
 		//	Calculate distance traveled
 		Double distance;
 		//	If the before/after positions
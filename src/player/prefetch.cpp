@@ -0,0 +1,140 @@
+#include <player/player.hpp>
+#include <server.hpp>
+#include <fma.hpp>
+#include <cmath>
+#include <exception>
+
+
+namespace MCPP {
+
+
+	//	Players moving slower than this (in
+	//	blocks per second) are not prefetched
+	//	for, walking is ~4.3 blocks per second
+	static const Double min_speed=3;
+	//	A component of a player's velocity must
+	//	be at least this fraction of their speed
+	//	to count towards their heading, this
+	//	gives eight possible headings
+	static const Double min_component=0.38;
+	//	How far ahead (in seconds) columns are
+	//	prefetched
+	static const Double lookahead_time=4;
+	//	The maximum number of columns ahead of
+	//	the player's view which are prefetched
+	static const Word max_lookahead=4;
+	static const Double column_width=16;
+	
+	
+	static SByte sign (Double component, Double speed) noexcept {
+	
+		if (component>=(speed*min_component)) return 1;
+		if (component<=-(speed*min_component)) return -1;
+		
+		return 0;
+	
+	}
+	
+	
+	Tuple<SByte,SByte,Word> Players::heading (const PlayerPosition & position) noexcept {
+	
+		Tuple<SByte,SByte,Word> retr(0,0,0);
+		
+		Double speed=sqrt(
+			fma(
+				position.VelocityX,
+				position.VelocityX,
+				position.VelocityZ*position.VelocityZ
+			)
+		);
+		if (!(speed>=min_speed)) return retr;
+		
+		Double columns=ceil((speed*lookahead_time)/column_width);
+		
+		retr.Item<0>()=sign(position.VelocityX,speed);
+		retr.Item<1>()=sign(position.VelocityZ,speed);
+		retr.Item<2>()=(columns>=max_lookahead) ? max_lookahead : static_cast<Word>(columns);
+		
+		return retr;
+	
+	}
+	
+	
+	void Players::prefetch (SmartPointer<Player> player, ColumnID id, Word priority) {
+	
+		//	Don't bother if the prefetch was
+		//	cancelled while it was queued
+		if (!player->Lock.Execute([&] () {
+		
+			return !player->Disconnected && (player->Prefetched.count(id)!=0);
+		
+		})) return;
+		
+		auto & world=World::Get();
+		
+		//	Interest is acquired at once, the column
+		//	is loaded in the background
+		world.Interested(id,true,priority).Then([] (Promise<void> p) {
+		
+			try {
+			
+				p.Get();
+			
+			} catch (...) {
+			
+				try {
+				
+					Server::Get().Panic(std::current_exception());
+				
+				} catch (...) {	}
+			
+			}
+		
+		});
+		
+		//	If the prefetch was cancelled while
+		//	interest was being acquired, nothing
+		//	else will end that interest
+		if (player->Lock.Execute([&] () {
+		
+			if (player->Disconnected) return false;
+			
+			auto iter=player->Prefetched.find(id);
+			if (iter==player->Prefetched.end()) return false;
+			
+			iter->second=true;
+			
+			return true;
+		
+		})) return;
+		
+		world.EndInterest(id);
+	
+	}
+	
+	
+	void Players::end_prefetch (Player & player) {
+	
+		Vector<ColumnID> end;
+		
+		player.Lock.Execute([&] () {
+		
+			for (auto & pair : player.Prefetched) if (pair.second) end.Add(pair.first);
+			
+			//	Prefetches which have not yet acquired
+			//	interest are cancelled by removing them,
+			//	they end their own interest
+			player.Prefetched.clear();
+			
+			player.HeadingX=0;
+			player.HeadingZ=0;
+			player.Lookahead=0;
+		
+		});
+		
+		for (auto & id : end) World::Get().EndInterest(id);
+	
+	}
+
+
+}
@@ -1,5 +1,6 @@
 #include <player/player.hpp>
 #include <server.hpp>
+#include <exception>
 
 
 namespace MCPP {
@@ -151,75 +152,92 @@ namespace MCPP {
 	
 		try {
 		
-			//	Express interest
+			//	Express interest, the column is prepared
+			//	without holding up this thread
 			World::Get().Interested(
 				interested[i]
-			);
-			
-			bool done;
-			interested_lock.Execute([&] () mutable {
+			).Then([this,i,then] (Promise<void> p) mutable {
 			
-				++interested_count;
-				
-				//	Log
-				Server::Get().WriteLog(
-					String::Format(
-						prepare_spawn_area_progress,
-						(static_cast<Double>(interested_count)/interested.Count())*100,
-						interested_count,
-						interested.Count()
-					),
-					Service::LogType::Information
-				);
+				try {
 				
-				//	Are we done?
-				if (interested_count==interested.Count()) {
-				
-					//	YES
+					p.Get();
+					
+					bool done;
+					interested_lock.Execute([&] () mutable {
 					
-					done=true;
+						++interested_count;
+						
+						//	Log
+						Server::Get().WriteLog(
+							String::Format(
+								prepare_spawn_area_progress,
+								(static_cast<Double>(interested_count)/interested.Count())*100,
+								interested_count,
+								interested.Count()
+							),
+							Service::LogType::Information
+						);
+						
+						//	Are we done?
+						if (interested_count==interested.Count()) {
+						
+							//	YES
+							
+							done=true;
+							
+							auto elapsed=interest_timer.ElapsedNanoseconds();
+							
+							//	Log
+							Server::Get().WriteLog(
+								String::Format(
+									prepare_spawn_area_complete,
+									interested.Count(),
+									elapsed,
+									(interested.Count()==0) ? 0 : (elapsed/interested.Count())
+								),
+								Service::LogType::Information
+							);
+							
+							//	Dispatch continuation (if applicable)
+							if (then) Server::Get().Pool().Enqueue(then);
+							
+							//	End lock
+							interested_locked=false;
+							interested_wait.WakeAll();
+						
+						} else {
+						
+							//	NO
+							
+							done=false;
+						
+						}
 					
-					auto elapsed=interest_timer.ElapsedNanoseconds();
+					});
 					
-					//	Log
-					Server::Get().WriteLog(
-						String::Format(
-							prepare_spawn_area_complete,
-							interested.Count(),
-							elapsed,
-							(interested.Count()==0) ? 0 : (elapsed/interested.Count())
-						),
-						Service::LogType::Information
-					);
+					//	If we're not done, and if we can
+					//	dispatch another callback, do so
+					if (!done) {
 					
-					//	Dispatch continuation (if applicable)
-					if (then) Server::Get().Pool().Enqueue(then);
+						Word index=i+cm->Maximum();
+						
+						if (index<interested.Count()) cm->Enqueue(
+							[=] () {	express_interest(index,std::move(then));	}
+						);
 					
-					//	End lock
-					interested_locked=false;
-					interested_wait.WakeAll();
+					}
 				
-				} else {
+				} catch (...) {
 				
-					//	NO
+					try {
 					
-					done=false;
+						Server::Get().Panic(std::current_exception());
+					
+					} catch (...) {	}
 				
 				}
 			
 			});
-			
-			//	If we're not done, and if we can
-			//	dispatch another callback, do so
-			if (!done) {
-			
-				Word index=i+cm->Maximum();
-				
-				if (index<interested.Count()) cm->Enqueue(
-					[=] () {	express_interest(index,std::move(then));	}
-				);
-			
-			}
 		
 		} catch (...) {
 		
@@ -2,12 +2,101 @@
 #include <server.hpp>
 #include <multi_scope_guard.hpp>
 #include <exception>
+#include <limits>
 #include <utility>
 
 
 namespace MCPP {
 
 
+	//	Prefetches are dispatched only once
+	//	every column players can see has been
+	//	dispatched
+	static const Word prefetch_bias=std::numeric_limits<Word>::max()/2;
+	
+	
+	//	The square of the distance, in columns,
+	//	between two columns
+	static Word distance (const ColumnID & a, const ColumnID & b) noexcept {
+	
+		Int64 x=static_cast<Int64>(a.X)-static_cast<Int64>(b.X);
+		Int64 z=static_cast<Int64>(a.Z)-static_cast<Int64>(b.Z);
+		
+		return static_cast<Word>((x*x)+(z*z));
+	
+	}
+	
+	
+	//	Creates a callback which prioritizes the
+	//	sending of a column to a player by its
+	//	distance from the player's current column,
+	//	and which drops the send once the player
+	//	no longer needs the column
+	static ConcurrencyManager::Priority add_priority (SmartPointer<Player> player, ColumnID id) {
+	
+		return [=] () {
+		
+			Nullable<Word> retr;
+			
+			player->Lock.Execute([&] () {
+			
+				if (player->Columns.count(id)==0) return;
+				
+				retr.Construct(
+					distance(
+						id,
+						ColumnID::GetContaining(
+							player->Position.X,
+							player->Position.Z,
+							player->Dimension
+						)
+					)
+				);
+			
+			});
+			
+			return retr;
+		
+		};
+	
+	}
+	
+	
+	//	Creates a callback which prioritizes a
+	//	prefetch after all columns players can
+	//	see, and which drops the prefetch once
+	//	it's cancelled
+	static ConcurrencyManager::Priority prefetch_priority (SmartPointer<Player> player, ColumnID id) {
+	
+		return [=] () {
+		
+			Nullable<Word> retr;
+			
+			player->Lock.Execute([&] () {
+			
+				auto iter=player->Prefetched.find(id);
+				if ((iter==player->Prefetched.end()) || iter->second) return;
+				
+				retr.Construct(
+					prefetch_bias+distance(
+						id,
+						ColumnID::GetContaining(
+							player->Position.X,
+							player->Position.Z,
+							player->Dimension
+						)
+					)
+				);
+			
+			});
+			
+			return retr;
+		
+		};
+	
+	}
+	
+	
 	void Players::update_position (SmartPointer<Player> & player, std::function<void ()> then) {
 	
 		//	Create a list of columns
@@ -16,9 +105,25 @@ namespace MCPP {
 		//	Create a list of columns which
 		//	must be removed from the player
 		Vector<ColumnID> remove;
+		//	Create lists of columns which must
+		//	be prefetched, and of columns in which
+		//	prefetching acquired interest that
+		//	must now be ended
+		Vector<ColumnID> prefetch_add;
+		Vector<ColumnID> prefetch_end;
+		//	Whether the player is in a different
+		//	column than when update_position last
+		//	ran, if so queued tasks must be
+		//	reprioritized
+		bool moved=false;
 	
 		player->Lock.Execute([&] () {
 		
+			//	The player's interest is ended when
+			//	they disconnect, it must not be
+			//	acquired again afterwards
+			if (player->Disconnected) return;
+		
 			//	Determine which column
 			//	the player is currently
 			//	in
@@ -75,6 +180,85 @@ namespace MCPP {
 				}
 			
 			}
+			
+			//	Which columns should be prefetched?
+			//
+			//	Only recomputed when the player changes
+			//	column or heading
+			auto h=heading(player->Position);
+			SByte heading_x=h.Item<0>();
+			SByte heading_z=h.Item<1>();
+			Word lookahead=h.Item<2>();
+			if (
+				(curr==player->PrefetchFrom) &&
+				(heading_x==player->HeadingX) &&
+				(heading_z==player->HeadingZ) &&
+				(lookahead==player->Lookahead)
+			) return;
+			
+			moved=curr!=player->PrefetchFrom;
+			
+			player->PrefetchFrom=curr;
+			player->HeadingX=heading_x;
+			player->HeadingZ=heading_z;
+			player->Lookahead=lookahead;
+			
+			//	The columns which will be in view once
+			//	the player has moved lookahead columns
+			//	in the direction of their heading, but
+			//	which are not yet in view
+			std::unordered_set<ColumnID> ahead;
+			Int32 distance=static_cast<Int32>(view_distance);
+			Int32 ahead_x=curr.X+(heading_x*static_cast<Int32>(lookahead));
+			Int32 ahead_z=curr.Z+(heading_z*static_cast<Int32>(lookahead));
+			for (
+				Int32 x=ahead_x-distance;
+				x<=(ahead_x+distance);
+				++x
+			) for (
+				Int32 z=ahead_z-distance;
+				z<=(ahead_z+distance);
+				++z
+			) if (
+				(x<(curr.X-distance)) ||
+				(x>(curr.X+distance)) ||
+				(z<(curr.Z-distance)) ||
+				(z>(curr.Z+distance))
+			) ahead.insert(
+				ColumnID{
+					x,
+					z,
+					player->Dimension
+				}
+			);
+			
+			//	Cancel prefetches which are no longer
+			//	ahead of the player, if they've
+			//	acquired interest it must be ended,
+			//	otherwise they end it themselves
+			for (auto iter=player->Prefetched.begin();iter!=player->Prefetched.end();) {
+			
+				if (ahead.count(iter->first)==0) {
+				
+					if (iter->second) prefetch_end.Add(iter->first);
+					
+					iter=player->Prefetched.erase(iter);
+				
+				} else {
+				
+					++iter;
+				
+				}
+			
+			}
+			
+			for (auto & id : ahead) if (player->Prefetched.count(id)==0) {
+			
+				prefetch_add.Add(id);
+				
+				player->Prefetched.emplace(id,false);
+			
+			}
 		
 		});
 		
@@ -85,34 +269,58 @@ namespace MCPP {
 			id
 		);
 		
+		for (auto & id : prefetch_end) World::Get().EndInterest(id);
+		
 		//	Scope guard to enable continuation
 		MultiScopeGuard sg;
 		
-		bool async;
-		if (then) {
-		
-			sg=MultiScopeGuard(
-				std::move(then),
-				std::function<void ()>(),	//	Nothing
-				[] () {	Server::Get().Panic();	}
-			);
-			
-			async=false;
-			
-		} else {
-		
-			async=true;
-		
-		}
+		if (then) sg=MultiScopeGuard(
+			std::move(then),
+			std::function<void ()>(),	//	Nothing
+			[] () {	Server::Get().Panic();	}
+		);
 		
+		//	Columns closest to the player are sent
+		//	first
 		for (auto & id : add) try {
 		
+			//	The task's slot is released once the
+			//	column has been passed to one of the
+			//	world's stages, which prepare columns
+			//	in order of the priority they're given
+			auto priority=add_priority(player,id);
 			cm->Enqueue(
-				[=] (MultiScopeGuard) {
+				priority,
+				[=] (MultiScopeGuard guard) {
 				
 					try {
-				
-						World::Get().Add(player->Conn,id,async);
+					
+						auto current=priority();
+						
+						//	The continuation is held until
+						//	the column is populated, without
+						//	waiting for it here
+						World::Get().Add(
+							player->Conn,
+							id,
+							current.IsNull() ? 0 : *current
+						).Then([guard] (Promise<void> p) mutable {
+						
+							try {
+							
+								p.Get();
+							
+							} catch (...) {
+							
+								try {
+								
+									Server::Get().Panic(std::current_exception());
+								
+								} catch (...) {	}
+							
+							}
+						
+						});
 						
 					} catch (...) {
 					
@@ -137,6 +345,54 @@ namespace MCPP {
 			throw;
 		
 		}
+		
+		//	Prefetches are enqueued after the columns
+		//	the player can actually see, and are not
+		//	part of the continuation
+		for (auto & id : prefetch_add) try {
+		
+			auto priority=prefetch_priority(player,id);
+			cm->Enqueue(
+				priority,
+				[=] () {
+				
+					try {
+					
+						auto current=priority();
+						
+						prefetch(
+							player,
+							id,
+							current.IsNull() ? prefetch_bias : *current
+						);
+					
+					} catch (...) {
+					
+						Server::Get().Panic(
+							std::current_exception()
+						);
+					
+					}
+				
+				}
+			);
+		
+		} catch (...) {
+		
+			try {
+			
+				Server::Get().Panic();
+			
+			} catch (...) {	}
+			
+			throw;
+		
+		}
+		
+		//	Tasks queued for this player (and others)
+		//	were prioritized by distance from where
+		//	the player was
+		if (moved) cm->Reprioritize();
 	
 	}
 
@@ -0,0 +1,422 @@
+#include <region_data_provider/region_data_provider.hpp>
+
+
+namespace MCPP {
+
+
+	namespace Region {
+	
+	
+		static const String name("Region Data Provider");
+		static const String separator(" / ");
+		static const String directory_label("Region Directory");
+		static const String open_label("Open Region Files");
+		static const String open_template("{0}");
+		static const String filename_template("r.{0}.{1}.{2}.mcr");
+		static const Regex header_regex("^column_(-?\\d+)_(-?\\d+)_(-?\\d+)$");
+		static const Regex section_regex("^column_(-?\\d+)_(-?\\d+)_(-?\\d+)_(\\d+)$");
+		static const String max_open_setting("region_max_open");
+		static const Word default_max_open=64;
+		static const String io_threads_setting("region_io_threads");
+		static const Word default_io_threads=4;
+		
+		
+		static Word get_setting (MCPP::DataProvider & dp, const String & setting, Word default_value) {
+		
+			auto value=dp.RetrieveSetting(setting);
+			
+			Word retr;
+			if (
+				value.IsNull() ||
+				!value->ToInteger(&retr) ||
+				(retr==0)
+			) return default_value;
+			
+			return retr;
+		
+		}
+		
+		
+		//	Divides rounding towards negative
+		//	infinity, so that negative column
+		//	coordinates map to the correct region
+		static Int32 floor_div (Int32 a, Int32 b) noexcept {
+		
+			Int32 q=a/b;
+			if (((a%b)!=0) && (a<0)) --q;
+			
+			return q;
+		
+		}
+		
+		
+		DataProvider::DataProvider (std::unique_ptr<MCPP::DataProvider> inner, String directory)
+			:	inner(std::move(inner)),
+				directory(std::move(directory)),
+				uses(0),
+				max_open(get_setting(*this->inner,max_open_setting,default_max_open)),
+				io(get_setting(*this->inner,io_threads_setting,default_io_threads))
+		{	}
+		
+		
+		std::shared_ptr<RegionFile> DataProvider::close_idle () {
+		
+			auto lru=regions.end();
+			for (auto iter=regions.begin();iter!=regions.end();++iter) {
+			
+				//	Only the map refers to this
+				//	file, so no one is using it
+				if (
+					iter->second.File.unique() &&
+					(
+						(lru==regions.end()) ||
+						(iter->second.LastUsed<lru->second.LastUsed)
+					)
+				) lru=iter;
+			
+			}
+			
+			if (lru==regions.end()) return std::shared_ptr<RegionFile>();
+			
+			auto retr=std::move(lru->second.File);
+			regions.erase(lru);
+			
+			return retr;
+		
+		}
+		
+		
+		std::shared_ptr<RegionFile> DataProvider::get (const ColumnKey & key, Word & index) {
+		
+			//	The header is in the first slot,
+			//	followed by each section
+			Word slot=(key.Section==ColumnKey::Header) ? 0 : (static_cast<Word>(key.Section)+1);
+			
+			constexpr auto width=static_cast<Int32>(RegionFile::Width);
+			RegionID id(key.Dimension,floor_div(key.X,width),floor_div(key.Z,width));
+			auto local_x=static_cast<Word>(key.X-(id.Item<1>()*width));
+			auto local_z=static_cast<Word>(key.Z-(id.Item<2>()*width));
+			index=(((local_z*RegionFile::Width)+local_x)*RegionFile::Slots)+slot;
+			
+			//	Closing a region file flushes its
+			//	index to disk, which is done after
+			//	the lock is released
+			std::shared_ptr<RegionFile> closed;
+			
+			//	Open the region file if it's not
+			//	already open
+			return regions_lock.Execute([&] () {
+			
+				auto iter=regions.find(id);
+				if (iter!=regions.end()) {
+				
+					iter->second.LastUsed=uses++;
+					
+					return iter->second.File;
+				
+				}
+				
+				if (regions.size()>=max_open) closed=close_idle();
+				
+				auto path=Path::Combine(
+					directory,
+					String::Format(
+						filename_template,
+						key.Dimension,
+						id.Item<1>(),
+						id.Item<2>()
+					)
+				);
+				
+				OpenRegion region;
+				region.File=std::make_shared<RegionFile>(path);
+				region.LastUsed=uses++;
+				auto retr=region.File;
+				regions.emplace(id,std::move(region));
+				
+				return retr;
+			
+			});
+		
+		}
+		
+		
+		bool DataProvider::get (const String & key, std::shared_ptr<RegionFile> & file, Word & index) {
+		
+			//	Determine whether this is a column
+			//	header or a section
+			ColumnKey column;
+			column.Section=ColumnKey::Header;
+			auto match=header_regex.Match(key);
+			if (!match.Success()) {
+			
+				match=section_regex.Match(key);
+				if (!match.Success()) return false;
+				
+				if (!(
+					match[4].Value().ToInteger(&column.Section) &&
+					(column.Section<(RegionFile::Slots-1))
+				)) return false;
+			
+			}
+			
+			if (!(
+				match[1].Value().ToInteger(&column.X) &&
+				match[2].Value().ToInteger(&column.Z) &&
+				match[3].Value().ToInteger(&column.Dimension)
+			)) return false;
+			
+			file=get(column,index);
+			
+			return true;
+		
+		}
+		
+		
+		DataProviderInfo DataProvider::GetInfo () {
+		
+			auto retr=inner->GetInfo();
+			retr.Name=name+separator+retr.Name;
+			
+			retr.Data.Add(
+				DataProviderDatum{
+					directory_label,
+					directory
+				}
+			);
+			
+			Word open=regions_lock.Execute([&] () {	return regions.size();	});
+			retr.Data.Add(
+				DataProviderDatum{
+					open_label,
+					String::Format(open_template,open)
+				}
+			);
+			
+			return retr;
+		
+		}
+		
+		
+		void DataProvider::WriteLog (const String & log, Service::LogType type) {
+		
+			inner->WriteLog(log,type);
+		
+		}
+		
+		
+		void DataProvider::WriteChatLog (const String & from, const Vector<String> & to, const String & message, const Nullable<String> & notes) {
+		
+			inner->WriteChatLog(from,to,message,notes);
+		
+		}
+		
+		
+		Nullable<Vector<Byte>> DataProvider::GetBinary (const String & key) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (get(key,file,index)) return file->Get(index);
+			
+			return inner->GetBinary(key);
+		
+		}
+		
+		
+		bool DataProvider::GetBinary (const String & key, void * ptr, Word * len) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (get(key,file,index)) return file->Get(index,ptr,len);
+			
+			return inner->GetBinary(key,ptr,len);
+		
+		}
+		
+		
+		void DataProvider::SaveBinary (const String & key, const void * ptr, Word len) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (get(key,file,index)) file->Save(index,ptr,len);
+			else inner->SaveBinary(key,ptr,len);
+		
+		}
+		
+		
+		void DataProvider::DeleteBinary (const String & key) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (get(key,file,index)) file->Delete(index);
+			else inner->DeleteBinary(key);
+		
+		}
+		
+		
+		Nullable<Vector<Byte>> DataProvider::GetColumn (const ColumnKey & key) {
+		
+			Word index;
+			auto file=get(key,index);
+			
+			return file->Get(index);
+		
+		}
+		
+		
+		void DataProvider::SaveColumn (const ColumnKey & key, const void * ptr, Word len) {
+		
+			Word index;
+			get(key,index)->Save(index,ptr,len);
+		
+		}
+		
+		
+		void DataProvider::DeleteColumn (const ColumnKey & key) {
+		
+			Word index;
+			get(key,index)->Delete(index);
+		
+		}
+		
+		
+		Promise<Nullable<Vector<Byte>>> DataProvider::GetBinaryAsync (String key) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (!get(key,file,index)) return inner->GetBinaryAsync(std::move(key));
+			
+			return io.Enqueue([file,index] () {	return file->Get(index);	});
+		
+		}
+		
+		
+		Promise<void> DataProvider::SaveBinaryAsync (String key, Vector<Byte> buffer) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (!get(key,file,index)) return inner->SaveBinaryAsync(std::move(key),std::move(buffer));
+			
+			return io.Enqueue(
+				[file,index] (const Vector<Byte> & buffer) {	file->Save(index,buffer.begin(),buffer.Count());	},
+				std::move(buffer)
+			);
+		
+		}
+		
+		
+		Promise<void> DataProvider::DeleteBinaryAsync (String key) {
+		
+			std::shared_ptr<RegionFile> file;
+			Word index;
+			if (!get(key,file,index)) return inner->DeleteBinaryAsync(std::move(key));
+			
+			return io.Enqueue([file,index] () {	file->Delete(index);	});
+		
+		}
+		
+		
+		Promise<Nullable<Vector<Byte>>> DataProvider::GetColumnAsync (ColumnKey key) {
+		
+			return io.Enqueue([this,key] () {	return GetColumn(key);	});
+		
+		}
+		
+		
+		Promise<Vector<Nullable<Vector<Byte>>>> DataProvider::GetColumnsAsync (Vector<ColumnKey> keys) {
+		
+			return io.Enqueue(
+				[this] (const Vector<ColumnKey> & keys) {	return GetColumns(keys);	},
+				std::move(keys)
+			);
+		
+		}
+		
+		
+		Promise<void> DataProvider::SaveColumnsAsync (Vector<ColumnData> data) {
+		
+			return io.Enqueue(
+				[this] (const Vector<ColumnData> & data) {	SaveColumns(data);	},
+				std::move(data)
+			);
+		
+		}
+		
+		
+		void DataProvider::SaveColumns (const Vector<ColumnData> & data) {
+		
+			//	Pieces are saved to each region
+			//	file at once, so that the file is
+			//	flushed once for all of them
+			Vector<Tuple<std::shared_ptr<RegionFile>,Vector<Tuple<Word,const void *,Word>>>> files;
+			for (auto & d : data) {
+			
+				Word index;
+				auto file=get(d.Key,index);
+				
+				Word i=0;
+				for (;i<files.Count();++i) if (files[i].Item<0>()==file) break;
+				if (i==files.Count()) files.EmplaceBack(std::move(file),Vector<Tuple<Word,const void *,Word>>());
+				
+				files[i].Item<1>().EmplaceBack(index,d.Pointer,d.Length);
+			
+			}
+			
+			for (auto & t : files) t.Item<0>()->Save(t.Item<1>());
+		
+		}
+		
+		
+		Nullable<String> DataProvider::RetrieveSetting (const String & setting) {
+		
+			return inner->RetrieveSetting(setting);
+		
+		}
+		
+		
+		void DataProvider::SetSetting (const String & setting, const Nullable<String> & value) {
+		
+			inner->SetSetting(setting,value);
+		
+		}
+		
+		
+		void DataProvider::DeleteSetting (const String & setting) {
+		
+			inner->DeleteSetting(setting);
+		
+		}
+		
+		
+		void DataProvider::InsertValue (const String & key, const String & value) {
+		
+			inner->InsertValue(key,value);
+		
+		}
+		
+		
+		void DataProvider::DeleteValues (const String & key, const String & value) {
+		
+			inner->DeleteValues(key,value);
+		
+		}
+		
+		
+		void DataProvider::DeleteValues (const String & key) {
+		
+			inner->DeleteValues(key);
+		
+		}
+		
+		
+		Vector<String> DataProvider::GetValues (const String & key) {
+		
+			return inner->GetValues(key);
+		
+		}
+	
+	
+	}
+
+
+}
@@ -0,0 +1,33 @@
+#include <region_data_provider/region_data_provider.hpp>
+#include <mysql_data_provider/mysql_data_provider.hpp>
+
+
+namespace MCPP {
+
+
+	//	Name of the directory in which region
+	//	files are stored
+	static const String regions_dir("regions");
+	
+	
+	DataProvider * DataProvider::GetDataProvider () {
+	
+		auto directory=Path::Combine(
+			Path::GetPath(
+				::File::GetCurrentExecutableFileName()
+			),
+			regions_dir
+		);
+		Region::MakeDirectory(directory);
+		
+		//	Settings, logs, and key/value pairs
+		//	are still stored in MySQL
+		return new Region::DataProvider(
+			std::unique_ptr<MCPP::DataProvider>(MySQL::Create()),
+			std::move(directory)
+		);
+	
+	}
+
+
+}
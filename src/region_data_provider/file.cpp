@@ -0,0 +1,343 @@
+#include <region_data_provider/region_data_provider.hpp>
+#include <system_error>
+#ifndef ENVIRONMENT_WINDOWS
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+
+namespace MCPP {
+
+
+	namespace Region {
+	
+	
+		[[noreturn]]
+		static void raise () {
+		
+			throw std::system_error(
+				std::error_code(
+					#ifdef ENVIRONMENT_WINDOWS
+					GetLastError(),
+					#else
+					errno,
+					#endif
+					std::system_category()
+				)
+			);
+		
+		}
+		
+		
+		void MakeDirectory (const String & path) {
+		
+			auto c_str=path.ToCString();
+			
+			#ifdef ENVIRONMENT_WINDOWS
+			
+			if (
+				(CreateDirectoryA(c_str.begin(),nullptr)==0) &&
+				(GetLastError()!=ERROR_ALREADY_EXISTS)
+			) raise();
+			
+			#else
+			
+			if (
+				(mkdir(c_str.begin(),0755)==-1) &&
+				(errno!=EEXIST)
+			) raise();
+			
+			#endif
+		
+		}
+		
+		
+		void File::destroy () noexcept {
+		
+			#ifdef ENVIRONMENT_WINDOWS
+			
+			if (map!=nullptr) {
+			
+				FlushViewOfFile(map,map_size);
+				UnmapViewOfFile(map);
+			
+			}
+			if (mapping!=nullptr) CloseHandle(mapping);
+			if (handle!=INVALID_HANDLE_VALUE) CloseHandle(handle);
+			
+			#else
+			
+			if (map!=nullptr) {
+			
+				msync(map,map_size,MS_SYNC);
+				munmap(map,map_size);
+			
+			}
+			if (handle!=-1) close(handle);
+			
+			#endif
+		
+		}
+		
+		
+		File::File (const String & path, Word map_size) : map(nullptr), map_size(map_size) {
+		
+			auto c_str=path.ToCString();
+			
+			#ifdef ENVIRONMENT_WINDOWS
+			
+			mapping=nullptr;
+			handle=CreateFileA(
+				c_str.begin(),
+				GENERIC_READ|GENERIC_WRITE,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_ALWAYS,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr
+			);
+			if (handle==INVALID_HANDLE_VALUE) raise();
+			
+			try {
+			
+				//	Creating a mapping larger than the
+				//	file extends the file with zeroes
+				mapping=CreateFileMappingA(
+					handle,
+					nullptr,
+					PAGE_READWRITE,
+					static_cast<DWORD>(static_cast<UInt64>(map_size)>>32),
+					static_cast<DWORD>(map_size),
+					nullptr
+				);
+				if (mapping==nullptr) raise();
+				
+				map=MapViewOfFile(
+					mapping,
+					FILE_MAP_ALL_ACCESS,
+					0,
+					0,
+					map_size
+				);
+				if (map==nullptr) raise();
+			
+			} catch (...) {
+			
+				destroy();
+				
+				throw;
+			
+			}
+			
+			#else
+			
+			handle=open(c_str.begin(),O_RDWR|O_CREAT,0644);
+			if (handle==-1) raise();
+			
+			try {
+			
+				//	Extend the file with zeroes if
+				//	it's too short to be mapped
+				if (Size()<map_size) {
+				
+					if (ftruncate(handle,static_cast<off_t>(map_size))==-1) raise();
+				
+				}
+				
+				auto ptr=mmap(
+					nullptr,
+					map_size,
+					PROT_READ|PROT_WRITE,
+					MAP_SHARED,
+					handle,
+					0
+				);
+				if (ptr==MAP_FAILED) raise();
+				map=ptr;
+			
+			} catch (...) {
+			
+				destroy();
+				
+				throw;
+			
+			}
+			
+			#endif
+		
+		}
+		
+		
+		File::~File () noexcept {
+		
+			destroy();
+		
+		}
+		
+		
+		void * File::Map () const noexcept {
+		
+			return map;
+		
+		}
+		
+		
+		UInt64 File::Size () const {
+		
+			#ifdef ENVIRONMENT_WINDOWS
+			
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(handle,&size)==0) raise();
+			
+			return static_cast<UInt64>(size.QuadPart);
+			
+			#else
+			
+			struct stat buf;
+			if (fstat(handle,&buf)==-1) raise();
+			
+			return static_cast<UInt64>(buf.st_size);
+			
+			#endif
+		
+		}
+		
+		
+		void File::Read (UInt64 offset, void * ptr, Word len) const {
+		
+			auto begin=reinterpret_cast<Byte *>(ptr);
+			
+			//	Loop until all bytes are read,
+			//	reads may be partial
+			while (len!=0) {
+			
+				#ifdef ENVIRONMENT_WINDOWS
+				
+				OVERLAPPED overlapped{};
+				overlapped.Offset=static_cast<DWORD>(offset);
+				overlapped.OffsetHigh=static_cast<DWORD>(offset>>32);
+				DWORD num;
+				if (ReadFile(
+					handle,
+					begin,
+					static_cast<DWORD>(len),
+					&num,
+					&overlapped
+				)==0) raise();
+				
+				#else
+				
+				auto num=pread(handle,begin,len,static_cast<off_t>(offset));
+				if (num==-1) {
+				
+					if (errno==EINTR) continue;
+					
+					raise();
+				
+				}
+				
+				#endif
+				
+				//	The file is shorter than it
+				//	should be
+				if (num==0) throw std::system_error(
+					std::make_error_code(
+						std::errc::io_error
+					)
+				);
+				
+				begin+=num;
+				offset+=static_cast<UInt64>(num);
+				len-=static_cast<Word>(num);
+			
+			}
+		
+		}
+		
+		
+		void File::Write (UInt64 offset, const void * ptr, Word len) {
+		
+			auto begin=reinterpret_cast<const Byte *>(ptr);
+			
+			//	Loop until all bytes are written,
+			//	writes may be partial
+			while (len!=0) {
+			
+				#ifdef ENVIRONMENT_WINDOWS
+				
+				OVERLAPPED overlapped{};
+				overlapped.Offset=static_cast<DWORD>(offset);
+				overlapped.OffsetHigh=static_cast<DWORD>(offset>>32);
+				DWORD num;
+				if (WriteFile(
+					handle,
+					begin,
+					static_cast<DWORD>(len),
+					&num,
+					&overlapped
+				)==0) raise();
+				
+				#else
+				
+				auto num=pwrite(handle,begin,len,static_cast<off_t>(offset));
+				if (num==-1) {
+				
+					if (errno==EINTR) continue;
+					
+					raise();
+				
+				}
+				
+				#endif
+				
+				begin+=num;
+				offset+=static_cast<UInt64>(num);
+				len-=static_cast<Word>(num);
+			
+			}
+		
+		}
+		
+		
+		void File::Sync () {
+		
+			#ifdef ENVIRONMENT_WINDOWS
+			
+			if (FlushFileBuffers(handle)==0) raise();
+			
+			#else
+			
+			while (fdatasync(handle)==-1) if (errno!=EINTR) raise();
+			
+			#endif
+		
+		}
+		
+		
+		void File::SyncMap () {
+		
+			#ifdef ENVIRONMENT_WINDOWS
+			
+			//	Flushing the view only begins writing
+			//	it, the file's buffers must then be
+			//	flushed
+			if (FlushViewOfFile(map,map_size)==0) raise();
+			Sync();
+			
+			#else
+			
+			if (msync(map,map_size,MS_SYNC)==-1) raise();
+			
+			#endif
+		
+		}
+	
+	
+	}
+
+
+}
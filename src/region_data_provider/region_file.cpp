@@ -0,0 +1,285 @@
+#include <region_data_provider/region_data_provider.hpp>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+
+namespace MCPP {
+
+
+	namespace Region {
+	
+	
+		constexpr Word RegionFile::Width;
+		constexpr Word RegionFile::Slots;
+		constexpr Word RegionFile::Entries;
+		constexpr Word RegionFile::SectorSize;
+		constexpr Word RegionFile::HeaderSectors;
+		
+		
+		Word RegionFile::sectors (Word len) noexcept {
+		
+			return (len+SectorSize-1)/SectorSize;
+		
+		}
+		
+		
+		Word RegionFile::occupied (Word len) noexcept {
+		
+			Word retr=sectors(len);
+			
+			return (retr==0) ? 1 : retr;
+		
+		}
+		
+		
+		RegionFile::RegionFile (const String & path)
+			:	file(path,HeaderSectors*SectorSize),
+				index(reinterpret_cast<Entry *>(file.Map()))
+		{
+		
+			//	Determine how many sectors are in
+			//	the file
+			Word count=static_cast<Word>(sectors(static_cast<Word>(file.Size())));
+			if (count<HeaderSectors) count=HeaderSectors;
+			
+			used=Vector<bool>(count);
+			for (Word i=0;i<count;++i) used.Add(i<HeaderSectors);
+			
+			//	Mark the sectors of each blob as
+			//	used, discarding entries which
+			//	are corrupt
+			for (Word i=0;i<Entries;++i) {
+			
+				auto & entry=index[i];
+				if (entry.Sector==0) continue;
+				
+				Word start=entry.Sector;
+				Word num=occupied(entry.Length);
+				
+				bool valid=(start>=HeaderSectors) && (start<=count) && (num<=(count-start));
+				if (valid) for (Word n=start;n<(start+num);++n) if (used[n]) {
+				
+					valid=false;
+					
+					break;
+				
+				}
+				
+				if (!valid) {
+				
+					entry.Sector=0;
+					entry.Length=0;
+					
+					continue;
+				
+				}
+				
+				for (Word n=start;n<(start+num);++n) used[n]=true;
+			
+			}
+		
+		}
+		
+		
+		Word RegionFile::allocate (Word num) {
+		
+			//	Find the first run of free sectors
+			//	large enough
+			Word run=0;
+			for (Word i=HeaderSectors;i<used.Count();++i) {
+			
+				if (used[i]) {
+				
+					run=0;
+					
+					continue;
+				
+				}
+				
+				if (++run==num) {
+				
+					Word start=i+1-num;
+					for (Word n=start;n<=i;++n) used[n]=true;
+					
+					return start;
+				
+				}
+			
+			}
+			
+			//	There is no such run, append to
+			//	the file (reusing any free sectors
+			//	at the end of the file)
+			Word start=used.Count()-run;
+			for (Word n=start;n<used.Count();++n) used[n]=true;
+			while (used.Count()<(start+num)) used.Add(true);
+			
+			return start;
+		
+		}
+		
+		
+		void RegionFile::release (Word start, Word num) noexcept {
+		
+			for (Word n=start;n<(start+num);++n) used[n]=false;
+		
+		}
+		
+		
+		Nullable<Vector<Byte>> RegionFile::Get (Word i) {
+		
+			return lock.Read([&] () {
+			
+				Nullable<Vector<Byte>> retr;
+				
+				const auto & entry=index[i];
+				if (entry.Sector==0) return retr;
+				
+				Word len=entry.Length;
+				retr.Construct(len);
+				retr->SetCount(len);
+				file.Read(
+					static_cast<UInt64>(entry.Sector)*SectorSize,
+					retr->begin(),
+					len
+				);
+				
+				return retr;
+			
+			});
+		
+		}
+		
+		
+		bool RegionFile::Get (Word i, void * ptr, Word * len) {
+		
+			return lock.Read([&] () {
+			
+				const auto & entry=index[i];
+				if (entry.Sector==0) return false;
+				
+				Word actual=entry.Length;
+				file.Read(
+					static_cast<UInt64>(entry.Sector)*SectorSize,
+					ptr,
+					(actual<*len) ? actual : *len
+				);
+				*len=actual;
+				
+				return true;
+			
+			});
+		
+		}
+		
+		
+		void RegionFile::Save (const Vector<Tuple<Word,const void *,Word>> & blobs) {
+		
+			for (auto & t : blobs) if (t.Item<2>()>std::numeric_limits<UInt32>::max()) throw std::overflow_error("Blob too large for region file");
+			
+			lock.Write([&] () {
+			
+				//	The sectors each new blob was
+				//	written to
+				Vector<Word> starts(blobs.Count());
+				
+				//	Write each new blob to sectors
+				//	which are not in use, so that the
+				//	blob it replaces remains intact
+				//	until the index is updated
+				try {
+				
+					bool written=false;
+					for (auto & t : blobs) {
+					
+						if (t.Item<1>()==nullptr) {
+						
+							starts.Add(0);
+							
+							continue;
+						
+						}
+						
+						Word num=occupied(t.Item<2>());
+						Word start=allocate(num);
+						starts.Add(start);
+						
+						file.Write(
+							static_cast<UInt64>(start)*SectorSize,
+							t.Item<1>(),
+							t.Item<2>()
+						);
+						
+						written=true;
+					
+					}
+					
+					if (written) file.Sync();
+				
+				} catch (...) {
+				
+					for (Word n=0;n<starts.Count();++n) if (starts[n]!=0) release(starts[n],occupied(blobs[n].Item<2>()));
+					
+					throw;
+				
+				}
+				
+				//	Point the index at the new blobs,
+				//	remembering which sectors the old
+				//	blobs occupied
+				Vector<Tuple<Word,Word>> freed(blobs.Count());
+				bool changed=false;
+				for (Word n=0;n<blobs.Count();++n) {
+				
+					auto & entry=index[blobs[n].Item<0>()];
+					if ((entry.Sector==0) && (starts[n]==0)) continue;
+					
+					changed=true;
+					
+					if (entry.Sector!=0) freed.EmplaceBack(
+						static_cast<Word>(entry.Sector),
+						occupied(entry.Length)
+					);
+					
+					entry.Sector=static_cast<UInt32>(starts[n]);
+					entry.Length=(starts[n]==0) ? 0 : static_cast<UInt32>(blobs[n].Item<2>());
+				
+				}
+				
+				if (!changed) return;
+				
+				//	If the index cannot be flushed the
+				//	old sectors are not freed, the next
+				//	time the file is opened only the
+				//	sectors the index refers to are used
+				file.SyncMap();
+				
+				for (auto & t : freed) release(t.Item<0>(),t.Item<1>());
+			
+			});
+		
+		}
+		
+		
+		void RegionFile::Save (Word i, const void * ptr, Word len) {
+		
+			Vector<Tuple<Word,const void *,Word>> blobs;
+			blobs.EmplaceBack(i,ptr,len);
+			
+			Save(blobs);
+		
+		}
+		
+		
+		void RegionFile::Delete (Word i) {
+		
+			Save(i,nullptr,0);
+		
+		}
+	
+	
+	}
+
+
+}
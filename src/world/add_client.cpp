@@ -4,20 +4,18 @@
 namespace MCPP {
 
 
-	void World::Add (SmartPointer<Client> client, ColumnID id, bool async) {
+	Promise<void> World::Add (SmartPointer<Client> client, ColumnID id, Word priority) {
 	
 		auto column=get_column(id);
 		
+		Promise<void> retr;
+		
 		try {
-	
-			//	Wait until column is populated, or
-			//	see if column will eventually enter
-			//	desired state
-			if (!(
-				async
-					?	column->Check(ColumnState::Populated)
-					:	column->WaitUntil(ColumnState::Populated)
-			)) process(*column);
+		
+			//	The column will be sent to the
+			//	client once it is populated, so
+			//	there's no need to wait for it
+			retr=when_populated(*column,priority);
 			
 			clients_lock.Execute([&] () {
 			
@@ -76,6 +74,8 @@ namespace MCPP {
 		}
 		
 		column->EndInterest();
+		
+		return retr;
 	
 	}
 	
@@ -0,0 +1,126 @@
+#include <world/world.hpp>
+#include <compression.hpp>
+#include <utility>
+
+
+namespace MCPP {
+
+
+	void World::cache_column (const ColumnSnapshot & snapshot) {
+	
+		if (cache_budget==0) return;
+		
+		//	Compress outside the lock, this is
+		//	the same format that is saved to the
+		//	backing store, so that it may be loaded
+		//	the same way
+		auto cached=std::make_shared<CachedColumn>();
+		auto header=snapshot.SerializeHeader();
+		cached->Header=Deflate(
+			header.begin(),
+			header.end()
+		);
+		cached->Size=cached->Header.Count();
+		
+		for (Word i=0;i<16;++i) {
+		
+			auto section=snapshot.SerializeSection(i);
+			if (section.IsNull()) continue;
+			
+			cached->Sections[i].Construct(
+				Deflate(
+					section->begin(),
+					section->end()
+				)
+			);
+			
+			cached->Size+=cached->Sections[i]->Count();
+		
+		}
+		
+		//	Columns larger than the entire cache
+		//	are never cached
+		if (cached->Size>cache_budget) {
+		
+			uncache_column(snapshot.ID);
+			
+			return;
+		
+		}
+		
+		//	Evicted columns are freed once
+		//	the lock is released
+		Vector<std::shared_ptr<CachedColumn>> evicted;
+		
+		cache_lock.Execute([&] () {
+		
+			auto iter=cache.find(snapshot.ID);
+			if (iter!=cache.end()) {
+			
+				cache_size-=iter->second->Size;
+				cache_order.erase(iter->second->Position);
+				evicted.Add(std::move(iter->second));
+				cache.erase(iter);
+			
+			}
+			
+			while ((cache_size+cached->Size)>cache_budget) {
+			
+				auto oldest=cache.find(cache_order.front());
+				cache_order.pop_front();
+				
+				cache_size-=oldest->second->Size;
+				evicted.Add(std::move(oldest->second));
+				cache.erase(oldest);
+			
+			}
+			
+			cached->Position=cache_order.insert(cache_order.end(),snapshot.ID);
+			cache_size+=cached->Size;
+			cache.emplace(snapshot.ID,std::move(cached));
+		
+		});
+	
+	}
+	
+	
+	std::shared_ptr<World::CachedColumn> World::uncache_column (ColumnID id) {
+	
+		return cache_lock.Execute([&] () {
+		
+			std::shared_ptr<CachedColumn> retr;
+			
+			auto iter=cache.find(id);
+			if (iter==cache.end()) return retr;
+			
+			retr=std::move(iter->second);
+			cache.erase(iter);
+			cache_order.erase(retr->Position);
+			cache_size-=retr->Size;
+			
+			return retr;
+		
+		});
+	
+	}
+	
+	
+	ColumnState World::load_cached (ColumnContainer & column, CachedColumn & cached) {
+	
+		++cache_hits;
+		
+		Nullable<Vector<Byte>> header;
+		header.Construct(std::move(cached.Header));
+		
+		auto keys=load_header(column,header);
+		if (keys.IsNull()) return ColumnState::Generating;
+		
+		Vector<Nullable<Vector<Byte>>> sections(keys->Count());
+		for (auto & k : *keys) sections.Add(std::move(cached.Sections[k.Section]));
+		
+		return load_sections(column,*keys,sections);
+	
+	}
+
+
+}
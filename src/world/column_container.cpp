@@ -1,14 +1,13 @@
 #include <world/world.hpp>
+#include <atomic>
 #include <cstring>
 #include <limits>
+#include <utility>
 
 
 namespace MCPP {
 
 
-	constexpr Word ColumnContainer::Size;
-
-
 	ColumnID ColumnContainer::ID () const noexcept {
 	
 		return id;
@@ -16,10 +15,16 @@ namespace MCPP {
 	}
 
 
-	ColumnContainer::ColumnContainer (ColumnID id) noexcept : Populated(false), id(id), target(ColumnState::Loading), sent(false), dirty(false) {
+	ColumnContainer::ColumnContainer (ColumnID id) noexcept : Populated(false), id(id), memory(0), target(ColumnState::Loading), sent(false), dirty(false), dirty_sections(0), heights_pending(false), writer(0), writes(0) {
 	
 		curr=static_cast<Word>(ColumnState::Loading);
 		interest=0;
+		released=0;
+		version=0;
+		readers=0;
+		for (auto & view : views) view=nullptr;
+		std::memset(section_changes,0,sizeof(section_changes));
+		std::memset(heights,0,sizeof(heights));
 	
 	}
 
@@ -29,7 +34,15 @@ namespace MCPP {
 		lock.Acquire();
 		
 		//	Set dirty flag appropriately
-		if (dirty) this->dirty=true;
+		//
+		//	State changes (i.e. generation and
+		//	population) may affect every section
+		if (dirty) {
+		
+			this->dirty=true;
+			dirty_sections=std::numeric_limits<UInt16>::max();
+		
+		}
 		
 		//	Set populated flag if appropriate
 		if (target==ColumnState::Populated) Populated=true;
@@ -94,24 +107,24 @@ namespace MCPP {
 	}
 
 
-	bool ColumnContainer::WaitUntil (ColumnState target) noexcept {
+	bool ColumnContainer::Check (ColumnState target) noexcept {
 	
-		//	Do not acquire lock, atomically check
+		//	Do not lock, atomically check
 		//	current state
 		Word t=static_cast<Word>(target);
 		
 		Word c=static_cast<Word>(curr);
 		
-		//	If the current state is as much or more
-		//	than what we require, return at once
+		//	If the current state is as much
+		//	or more than what we require
+		//	return true at once
 		if (t<=c) return true;
 		
 		lock.Acquire();
 		
-		//	Reload in case state has
-		//	changed
+		//	Reload in case the state changed
 		c=static_cast<Word>(curr);
-		//	Recheck in case state has
+		//	Recheck in case the state has
 		//	changed
 		if (t<=c) {
 		
@@ -121,86 +134,31 @@ namespace MCPP {
 		
 		}
 		
-		//	Load target state
+		//	If the column is being processed,
+		//	it will enter the requisite state
+		//	once the target is updated
 		Word tt=static_cast<Word>(this->target);
+		bool retr=c!=tt;
 		
-		//	Check to see if this column is
-		//	being processed
-		bool retr;
-		if (c==tt) {
-		
-			//	The current and target states are
-			//	identical, which means that no
-			//	processing is currently occurring
-			//
-			//	Therefore we must inform the caller
-			//	that they must do the processing
-			
-			//	Set the target
-			this->target=target;
-			
-			retr=false;
-		
-		} else {
-		
-			//	The column is currently being processed
-			
-			//	Is the level of processing we desire
-			//	more than what is currently planned?
-			//
-			//	If so update the target
-			if (t>tt) this->target=target;
-			
-			retr=true;
-			
-			//	Wait for processing to reach the
-			//	appropriate point
-			while (static_cast<Word>(curr)<t) wait.Sleep(lock);
-		
-		}
+		//	Update target state
+		if (t>tt) this->target=target;
 		
 		lock.Release();
 		
+		//	If the column is not being processed,
+		//	inform caller they must process
 		return retr;
 	
 	}
 	
 	
-	bool ColumnContainer::Check (ColumnState target) noexcept {
+	void ColumnContainer::Sleep (ColumnState target, Word milliseconds) noexcept {
 	
-		//	Do not lock, atomically check
-		//	current state
 		Word t=static_cast<Word>(target);
 		
-		Word c=static_cast<Word>(curr);
-		
-		//	If the current state is as much
-		//	or more than what we require
-		//	return true at once
-		if (t<=c) return true;
-		
-		lock.Acquire();
-		
-		//	Reload in case the state changed
-		c=static_cast<Word>(curr);
-		//	Recheck in case the state has
-		//	changed
-		if (t<=c) {
-		
-			lock.Release();
-			
-			return true;
-		
-		}
-		
-		//	Update target state
-		this->target=target;
-		
-		lock.Release();
+		if (t<=static_cast<Word>(curr)) return;
 		
-		//	Inform caller they must
-		//	process
-		return false;
+		lock.Execute([&] () {	if (static_cast<Word>(curr)<t) wait.Sleep(lock,milliseconds);	});
 	
 	}
 	
@@ -324,13 +282,15 @@ namespace MCPP {
 	
 		lock.Acquire();
 		
-		sent=true;
-		
 		//	Do not perform a bulk send if
 		//	one has already been performed,
 		//	or if there are no clients to
 		//	send to
-		if (sent || (clients.size()==0)) {
+		bool send=!(sent || (clients.size()==0));
+		
+		sent=true;
+		
+		if (!send) {
 		
 			lock.Release();
 			
@@ -340,10 +300,13 @@ namespace MCPP {
 		
 		try {
 		
-			//	Get a packet
-			auto packet=ToChunkData();
+			//	Get a packet -- this is generated
+			//	once and the same bytes are sent
+			//	to every client
+			const auto & buffer=get_chunk_data();
 			
-			for (auto & c : clients) const_cast<SmartPointer<Client> &>(c)->Send(packet);
+			auto & world=World::Get();
+			for (auto & c : clients) world.send_column(c,id,buffer);
 		
 		} catch (...) {
 		
@@ -371,7 +334,7 @@ namespace MCPP {
 			
 				try {
 				
-					client->Send(ToChunkData());
+					World::Get().send_column(client,id,get_chunk_data());
 				
 				} catch (...) {
 				
@@ -394,19 +357,22 @@ namespace MCPP {
 	
 		lock.Execute([&] () {
 		
+			if (clients.erase(client)==0) return;
+			
+			if (clients.size()==0) released=World::Get().now();
+			
+			//	If the column was never actually
+			//	sent to the client, there's nothing
+			//	to unload
+			if (World::Get().cancel_column(client,id)) return;
+			
 			//	Send only if:
 			//
-			//	A.	The client had been added
-			//		to this column.
-			//	B.	This column had been sent
+			//	A.	This column had been sent
 			//		to clients.
-			//	C.	This isn't a forceful
+			//	B.	This isn't a forceful
 			//		removal.
-			if (
-				(clients.erase(client)!=0) &&
-				!force &&
-				sent
-			) client->Send(GetUnload());
+			if (!force && sent) client->Send(GetUnload());
 		
 		});
 	
@@ -422,7 +388,7 @@ namespace MCPP {
 	
 	void ColumnContainer::EndInterest () noexcept {
 	
-		--interest;
+		if (--interest==0) released=World::Get().now();
 	
 	}
 	
@@ -434,6 +400,13 @@ namespace MCPP {
 	}
 	
 	
+	UInt64 ColumnContainer::Released () const noexcept {
+	
+		return released;
+	
+	}
+	
+	
 	ColumnContainer::PacketType ColumnContainer::GetUnload () const {
 	
 		PacketType retr;
@@ -463,47 +436,24 @@ namespace MCPP {
 		//	bottom-to-top which are not
 		//	all air
 		bool chunks [16];
-		std::memset(chunks,0,sizeof(chunks));
 		//	This gives all chunks from
 		//	bottom-to-top which require the
 		//	"add" array
 		bool add [16];
-		std::memset(add,0,sizeof(add));
 		
-		//	Scan all blocks to determine
+		//	Each section counts its blocks as
+		//	they're written, which tells us
 		//
 		//	A.	Which chunks we need to send.
 		//	B.	Which of A need the add array.
-		Word chunk=0;
-		Word next_chunk=16*16*16;
-		for (Word i=0;i<(16*16*16*16);++i) {
+		//
+		//	Without scanning individual blocks
+		for (Word i=0;i<16;++i) {
 		
-			//	Maintain record of which
-			//	chunk we're in
-			if (i==next_chunk) {
-			
-				next_chunk+=16*16*16;
-				++chunk;
-			
-			}
+			const auto & section=sections[i];
 			
-			//	Type of this block
-			auto type=Blocks[i].GetType();
-			
-			//	Are we sending this chunk?
-			if (type!=0) {
-			
-				//	YES
-				
-				chunks[chunk]=true;
-				
-				//	Is the block type too large
-				//	for one byte?  I.e. do we have
-				//	to send the add array for this
-				//	chunk?
-				if (type>std::numeric_limits<Byte>::max()) add[chunk]=true;
-			
-			}
+			chunks[i]=section && !section->IsEmpty();
+			add[i]=chunks[i] && section->RequiresAdd();
 		
 		}
 		
@@ -553,67 +503,56 @@ namespace MCPP {
 		Word offset=0;
 		Word nibble_offset=spacing;
 		spacing/=2;
-		chunk=0;
-		next_chunk=16*16*16;
-		bool even=true;
-		for (Word i=0;i<(16*16*16*16);++i) {
+		for (Word chunk=0;chunk<16;++chunk) {
 		
-			//	Advance to next chunk if
-			//	necessary
-			if (i==next_chunk) {
-			
-				next_chunk+=16*16*16;
-				++chunk;
-			
-			}
-			
 			//	Skip null chunks
-			if (!chunks[chunk]) {
+			if (!chunks[chunk]) continue;
 			
-				i+=(16*16*16)-1;
-				
-				continue;
-			
-			}
+			const auto & section=*sections[chunk];
 			
-			//	Current block
-			const auto & b=Blocks[i];
-			
-			//	Write non-"add" byte of block
-			//	type
-			column[offset++]=static_cast<Byte>(b.GetType());
-			Word curr=nibble_offset;
-			//	Write nibbles
-			if (even) {
-			
-				//	Metadata
-				column[curr]=b.GetMetadata()<<4;
-				//	Light
-				column[curr+=spacing]=b.GetLight()<<4;
-				//	Skylight (if applicable)
-				if (skylight) column[curr+spacing]=b.GetSkylight()<<4;
-				//	"Add" (if applicable)
-				if (add[chunk]) column[add_offset]=get_add(b)<<4;
+			bool even=true;
+			for (Word i=0;i<ColumnSection::Count;++i) {
 			
-			} else {
-			
-				//	Metadata
-				column[curr]|=b.GetMetadata();
-				//	Light
-				column[curr+=spacing]|=b.GetLight();
-				//	Skylight (if applicable)
-				if (skylight) column[curr+spacing]|=b.GetSkylight();
-				//	"Add" (if applicable)
-				if (add[chunk]) column[add_offset++]|=get_add(b);
+				//	Current block
+				auto b=section.Get(i);
+				
+				//	Write non-"add" byte of block
+				//	type
+				column[offset++]=static_cast<Byte>(b.GetType());
+				Word curr=nibble_offset;
+				//	Write nibbles
+				if (even) {
+				
+					//	Metadata
+					column[curr]=b.GetMetadata()<<4;
+					//	Light
+					column[curr+=spacing]=b.GetLight()<<4;
+					//	Skylight (if applicable)
+					if (skylight) column[curr+spacing]=b.GetSkylight()<<4;
+					//	"Add" (if applicable)
+					if (add[chunk]) column[add_offset]=get_add(b)<<4;
+				
+				} else {
+				
+					//	Metadata
+					column[curr]|=b.GetMetadata();
+					//	Light
+					column[curr+=spacing]|=b.GetLight();
+					//	Skylight (if applicable)
+					if (skylight) column[curr+spacing]|=b.GetSkylight();
+					//	"Add" (if applicable)
+					if (add[chunk]) column[add_offset++]|=get_add(b);
+					
+					//	After every odd/even pair,
+					//	we move onto the next full
+					//	byte
+					++nibble_offset;
 				
-				//	After every odd/even pair,
-				//	we move onto the next full
-				//	byte
-				++nibble_offset;
+				}
+				
+				even=!even;
 			
 			}
-			
-			even=!even;
 		
 		}
 		
@@ -641,43 +580,762 @@ namespace MCPP {
 	}
 	
 	
-	void ColumnContainer::SetBlock (BlockID id, Block block) {
+	const Vector<Byte> & ColumnContainer::get_chunk_data () {
+	
+		//	Generating the packet requires a scan
+		//	of the entire column and a deflate
+		//	operation, so the result is retained
+		//	until the column changes
+		if (cache.IsNull()) cache.Construct(MCPP::Serialize(ToChunkData()));
+		
+		return *cache;
+	
+	}
+	
+	
+	void ColumnContainer::Write (Word offset, Block block) {
+	
+		//	Any cached packet is now stale
+		cache.Destroy();
+	
+		Word i=offset/ColumnSection::Count;
+		auto & section=sections[i];
+		
+		if (section && (section.use_count()==1) && section->Fits(block)) {
+		
+			//	Threads reading without the lock
+			//	discard anything they read while
+			//	the section changes, the section
+			//	stores its indices atomically so
+			//	that what they read is never torn
+			++version;
+			
+			section->Set(offset%ColumnSection::Count,block);
+			
+			version.fetch_add(1,std::memory_order_release);
+		
+		} else {
+		
+			//	Writing air into a section which
+			//	is entirely air changes nothing
+			if (!section && (block==empty())) return;
+			
+			//	Sections shared with snapshots, and
+			//	changes which would reallocate part of
+			//	a section, are made to a copy which
+			//	then replaces the section, so that
+			//	threads reading without the lock never
+			//	read freed memory
+			auto copy=section ? std::make_shared<ColumnSection>(*section) : std::make_shared<ColumnSection>();
+			copy->Set(offset%ColumnSection::Count,block);
+			
+			replace(i,std::move(copy));
+		
+		}
+		
+		update_height(offset,block.GetType()==0);
+	
+	}
+	
+	
+	void ColumnContainer::update_height (Word offset, bool air) noexcept {
+	
+		Word i=offset%(16*16);
+		Word y=offset/(16*16);
+		auto & height=heights[i];
+		
+		if (!air) {
+		
+			if (y>=height) height=static_cast<UInt16>(y+1);
+			
+			return;
+		
+		}
+		
+		//	Only removing the highest block
+		//	lowers the height, in which case
+		//	the next highest must be found
+		if ((y+1)!=height) return;
+		
+		while ((height!=0) && (Read(((height-1)*16*16)+i).GetType()==0)) --height;
+	
+	}
+	
+	
+	Word ColumnContainer::GetHeight (Word x, Word z) const noexcept {
+	
+		return lock.Execute([&] () {	return static_cast<Word>(heights[(z*16)+x]);	});
+	
+	}
+	
+	
+	void ColumnContainer::EnsureHeights () noexcept {
+	
+		if (!heights_pending) return;
+		
+		for (Word i=0;i<(16*16);++i) {
+		
+			UInt16 height=256;
+			while ((height!=0) && (Read(((height-1)*16*16)+i).GetType()==0)) --height;
+			
+			heights[i]=height;
+		
+		}
+		
+		heights_pending=false;
+		
+		//	The height map must be saved
+		dirty=true;
+	
+	}
+	
+	
+	Block ColumnContainer::Read (Word offset) const noexcept {
+	
+		const auto & section=sections[offset/ColumnSection::Count];
+		
+		return section ? section->Get(offset%ColumnSection::Count) : empty();
+	
+	}
+	
+	
+	Block ColumnContainer::empty () const noexcept {
+	
+		//	Clients treat sections which aren't
+		//	sent as having full skylight
+		Block retr;
+		if (HasSkylight(id.Dimension)) retr.SetSkylight(15);
+		
+		return retr;
+	
+	}
+	
+	
+	//	Once this many block changes are buffered
+	//	they are sent at once rather than waiting
+	//	for the next flush
+	static const Word max_changes=512;
+	//	If more than this many blocks change in a
+	//	single section between flushes, the entire
+	//	column is resent rather than sending each
+	//	change
+	static const Word section_change_cutoff=64;
+	
+	
+	void ColumnContainer::set_block (Word offset, Block block) {
+	
+		//	Prepare a record in the format used
+		//	by the 0x22 packet
+		UInt32 record=(
+			(static_cast<UInt32>(offset%16)<<28) |
+			(static_cast<UInt32>((offset/16)%16)<<24) |
+			(static_cast<UInt32>(offset/(16*16))<<16) |
+			(static_cast<UInt32>(block.GetType()&0xFFF)<<4) |
+			static_cast<UInt32>(block.GetMetadata()&0xF)
+		);
+		
+		//	Keep the block's light, the lighting
+		//	engine updates it if necessary
+		auto curr=Read(offset);
+		block.SetLight(curr.GetLight());
+		block.SetSkylight(curr.GetSkylight());
+		
+		//	Assign block
+		Write(offset,block);
+		
+		//	The section containing the
+		//	block is now dirty
+		dirty_sections|=static_cast<UInt16>(1)<<(offset/ColumnSection::Count);
+		
+		//	If this column hasn't been sent to
+		//	players, there's nobody to inform
+		if (!sent || (clients.size()==0)) return;
+		
+		//	Buffer the change
+		Word count=changes.Count()+sizeof(record);
+		while (changes.Capacity()<count) changes.SetCapacity();
+		Byte * ptr=changes.end();
+		for (Word i=sizeof(record);(i--)>0;) *(ptr++)=static_cast<Byte>(record>>(i*BitsPerByte()));
+		changes.SetCount(count);
+		++section_changes[offset/ColumnSection::Count];
+	
+	}
+	
+	
+	bool ColumnContainer::buffered (bool first) {
+	
+		//	If enough changes have been buffered,
+		//	send them at once
+		if ((changes.Count()/sizeof(UInt32))>=max_changes) {
+		
+			flush();
+			
+			return false;
+		
+		}
+		
+		return first && (changes.Count()!=0);
+	
+	}
+	
+	
+	bool ColumnContainer::SetBlock (BlockID id, Block block) {
 	
 		//	Get offset within this column
 		auto offset=id.GetOffset();
 		
-		//	Prepare a packet
-		Packets::Play::Clientbound::BlockChange packet;
+		return lock.Execute([&] () {
+		
+			bool first=changes.Count()==0;
+			
+			set_block(offset,block);
+			
+			return buffered(first);
+		
+		});
+	
+	}
+	
+	
+	bool ColumnContainer::SetBlocks (const Vector<Tuple<Word,Block>> & blocks) {
+	
+		return lock.Execute([&] () {	return SetBlocksAcquired(blocks);	});
+	
+	}
+	
+	
+	bool ColumnContainer::SetBlocksAcquired (const Vector<Tuple<Word,Block>> & blocks) {
+	
+		bool first=changes.Count()==0;
+		
+		for (auto & t : blocks) set_block(t.Item<0>(),t.Item<1>());
+		
+		return buffered(first);
+	
+	}
+	
+	
+	void ColumnContainer::flush () {
+	
+		if (changes.Count()==0) return;
+		
+		//	Determine whether any section has
+		//	changed so much that it's cheaper
+		//	to send the entire column
+		bool resend=false;
+		for (auto c : section_changes) if (c>section_change_cutoff) {
+		
+			resend=true;
+			
+			break;
+		
+		}
+		
+		//	Take the buffered changes, resetting
+		//	the buffer
+		auto data=std::move(changes);
+		changes=Vector<Byte>();
+		std::memset(section_changes,0,sizeof(section_changes));
+		
+		auto & world=World::Get();
+		
+		if (resend) {
+		
+			const auto & buffer=get_chunk_data();
+			
+			for (auto & client : clients) world.send_column(client,id,buffer);
+			
+			return;
+		
+		}
+		
+		//	Prepare a packet, serializing it only
+		//	once for all clients
+		Packets::Play::Clientbound::MultiBlockChange packet;
 		packet.X=id.X;
-		packet.Y=id.Y;
 		packet.Z=id.Z;
-		packet.Type=block.GetType();
-		packet.Metadata=block.GetMetadata();
+		packet.Count=static_cast<Int16>(data.Count()/sizeof(UInt32));
+		packet.Data=std::move(data);
+		auto buffer=MCPP::Serialize(packet);
 		
+		//	Clients to which the column's send has
+		//	been deferred haven't received the column,
+		//	and so couldn't apply the changes, the
+		//	deferred send is updated instead
+		for (auto & client : clients) {
+		
+			if (world.is_deferred(client,id)) world.send_column(client,id,get_chunk_data());
+			else const_cast<SmartPointer<Client> &>(client)->Send(buffer);
+		
+		}
+	
+	}
+	
+	
+	void ColumnContainer::SetLight (Word offset, Byte light, bool sky) {
+	
 		lock.Execute([&] () {
 		
-			//	Assign block
-			Blocks[offset]=block;
+			auto block=Read(offset);
+			if ((sky ? block.GetSkylight() : block.GetLight())==light) return;
 			
-			//	Now dirty
-			dirty=true;
+			if (sky) block.SetSkylight(light);
+			else block.SetLight(light);
+			
+			Write(offset,block);
+			
+			dirty_sections|=static_cast<UInt16>(1)<<(offset/ColumnSection::Count);
+		
+		});
+	
+	}
+	
+	
+	void ColumnContainer::Flush () {
+	
+		lock.Execute([&] () {
+		
+			flush();
 			
-			//	If we've sent this column to players,
-			//	send a packet
-			if (sent) for (auto & client : clients) const_cast<SmartPointer<Client> &>(client)->Send(packet);
+			reclaim();
 		
 		});
 	
 	}
 	
 	
+	bool ColumnContainer::BeginWrite (Word writer, bool block) {
+	
+		return lock.Execute([&] () {
+		
+			if (this->writer!=writer) {
+			
+				while (this->writer!=0) {
+				
+					if (!block) return false;
+					
+					wait.Sleep(lock);
+				
+				}
+				
+				this->writer=writer;
+			
+			}
+			
+			++writes;
+			
+			return true;
+		
+		});
+	
+	}
+	
+	
+	void ColumnContainer::EndWrite () noexcept {
+	
+		lock.Execute([&] () {
+		
+			if (--writes!=0) return;
+			
+			writer=0;
+			
+			//	Writers waiting for access wait
+			//	on the same condition variable
+			//	as changes of state
+			wait.WakeAll();
+		
+		});
+	
+	}
+	
+	
+	//	The number of times a read without the
+	//	lock is attempted before the lock is
+	//	acquired
+	static const Word read_attempts=4;
+	
+	
+	bool ColumnContainer::read (const Word * offsets, Block * blocks, Word count) const noexcept {
+	
+		//	Sections are only freed while there
+		//	are no readers.
+		//
+		//	The writer publishes a new view and
+		//	then checks for readers, the reader
+		//	announces itself and then loads views,
+		//	so without a full fence each could miss
+		//	the other's store, and the reader could
+		//	use a section which is being freed
+		++readers;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		
+		UInt64 before=version.load(std::memory_order_acquire);
+		
+		bool retr=false;
+		
+		//	If the version is odd a change is
+		//	in progress
+		if ((before%2)==0) {
+		
+			for (Word i=0;i<count;++i) {
+			
+				auto offset=offsets[i];
+				auto section=views[offset/ColumnSection::Count].load(std::memory_order_acquire);
+				
+				blocks[i]=(section==nullptr) ? empty() : section->Get(offset%ColumnSection::Count);
+			
+			}
+			
+			std::atomic_thread_fence(std::memory_order_acquire);
+			
+			//	If the version hasn't changed, no
+			//	change was made while reading
+			retr=version.load(std::memory_order_relaxed)==before;
+		
+		}
+		
+		--readers;
+		
+		return retr;
+	
+	}
+	
+	
 	Block ColumnContainer::GetBlock (BlockID id) const noexcept {
 	
 		//	Get offset within this column
 		auto offset=id.GetOffset();
 		
-		//	Retrieve the appropriate block
-		return lock.Execute([&] () {	return Blocks[offset];	});
+		Block retr;
+		for (Word i=0;i<read_attempts;++i) if (read(&offset,&retr,1)) return retr;
+		
+		//	Writes keep interrupting, wait
+		//	for them
+		return lock.Execute([&] () {	return Read(offset);	});
+	
+	}
+	
+	
+	void ColumnContainer::GetBlocks (const Word * offsets, Block * blocks, Word count) const noexcept {
+	
+		for (Word i=0;i<read_attempts;++i) if (read(offsets,blocks,count)) return;
+		
+		lock.Execute([&] () {	for (Word i=0;i<count;++i) blocks[i]=Read(offsets[i]);	});
+	
+	}
+	
+	
+	void ColumnContainer::Compact () {
+	
+		for (Word i=0;i<16;++i) {
+		
+			const auto & section=sections[i];
+			UInt16 mask=static_cast<UInt16>(1)<<i;
+			
+			//	Only sections which have been
+			//	modified can have stale palette
+			//	entries
+			if (!section || ((dirty_sections&mask)==0)) continue;
+			
+			//	Compacting reallocates the section,
+			//	so it's done to a copy (see Write)
+			auto copy=std::make_shared<ColumnSection>(*section);
+			copy->Compact();
+			
+			//	Sections which have become entirely
+			//	air needn't be stored at all
+			if (copy->IsAir(empty())) copy.reset();
+			
+			replace(i,std::move(copy));
+		
+		}
+		
+		reclaim();
+	
+	}
+	
+	
+	Word ColumnContainer::Memory () const noexcept {
+	
+		return sizeof(ColumnContainer)+memory;
+	
+	}
+	
+	
+	//	The size of a column as it was stored
+	//	before columns were stored as sections:
+	//	every block, followed by biomes, followed
+	//	by the populated flag
+	static constexpr Word legacy_size=(16*16*16*16*sizeof(Block))+(16*16*sizeof(Biome))+sizeof(bool);
+	//	Flags in the first byte of a column's
+	//	header
+	static const Byte populated_flag=1;
+	//	Headers written before height maps were
+	//	introduced do not have this flag
+	static const Byte heights_flag=2;
+	
+	
+	void ColumnContainer::replace (Word i, std::shared_ptr<ColumnSection> section) {
+	
+		auto & old=sections[i];
+		
+		//	Threads reading without the lock may
+		//	still be reading the old section
+		if (old) {
+		
+			retired.Add(old);
+			
+			memory-=old->Memory();
+		
+		}
+		
+		if (section) memory+=section->Memory();
+		
+		++version;
+		
+		old=std::move(section);
+		views[i]=old.get();
+		
+		version.fetch_add(1,std::memory_order_release);
+		
+		reclaim();
+	
+	}
+	
+	
+	void ColumnContainer::publish () noexcept {
+	
+		++version;
+		
+		for (Word i=0;i<16;++i) views[i]=sections[i].get();
+		
+		version.fetch_add(1,std::memory_order_release);
+	
+	}
+	
+	
+	void ColumnContainer::reclaim () noexcept {
+	
+		//	Threads which begin reading after this
+		//	check find the current sections
+		if ((retired.Count()!=0) && (readers==0)) retired.Clear();
+	
+	}
+	
+	
+	ColumnSnapshot ColumnContainer::Snapshot () const {
+	
+		ColumnSnapshot retr;
+		retr.ID=id;
+		std::memcpy(retr.Biomes,Biomes,sizeof(Biomes));
+		retr.Populated=Populated;
+		retr.Dirty=dirty_sections;
+		for (Word i=0;i<16;++i) retr.Sections[i]=sections[i];
+		std::memcpy(retr.Heights,heights,sizeof(heights));
+		
+		return retr;
+	
+	}
+	
+	
+	Vector<Byte> ColumnSnapshot::SerializeHeader () const {
+	
+		UInt16 mask=0;
+		for (Word i=0;i<16;++i) if (Sections[i]) mask|=static_cast<UInt16>(1)<<i;
+		
+		Word size=sizeof(Byte)+sizeof(Biomes)+sizeof(mask)+sizeof(Heights);
+		
+		Vector<Byte> retr(size);
+		retr.SetCount(size);
+		
+		Byte * ptr=retr.begin();
+		*(ptr++)=(Populated ? populated_flag : 0)|heights_flag;
+		std::memcpy(ptr,Biomes,sizeof(Biomes));
+		ptr+=sizeof(Biomes);
+		std::memcpy(ptr,&mask,sizeof(mask));
+		ptr+=sizeof(mask);
+		std::memcpy(ptr,Heights,sizeof(Heights));
+		
+		return retr;
+	
+	}
+	
+	
+	Nullable<Vector<Byte>> ColumnSnapshot::SerializeSection (Word i) const {
+	
+		Nullable<Vector<Byte>> retr;
+		
+		const auto & section=Sections[i];
+		if (section) {
+		
+			retr.Construct();
+			section->Serialize(*retr);
+		
+		}
+		
+		return retr;
+	
+	}
+	
+	
+	bool ColumnContainer::Deserialize (const Vector<Byte> & buffer, UInt16 & pending) {
+	
+		const Byte * begin=buffer.begin();
+		const Byte * end=buffer.end();
+		
+		cache.Destroy();
+		
+		//	Attempt to parse the buffer as a
+		//	sparse column first
+		bool success=[&] () {
+		
+			UInt16 mask;
+			if (static_cast<Word>(end-begin)<(sizeof(Byte)+sizeof(Biomes)+sizeof(mask))) return false;
+			
+			Byte flags=*(begin++);
+			if ((flags&~(populated_flag|heights_flag))!=0) return false;
+			Populated=(flags&populated_flag)!=0;
+			std::memcpy(Biomes,begin,sizeof(Biomes));
+			begin+=sizeof(Biomes);
+			std::memcpy(&mask,begin,sizeof(mask));
+			begin+=sizeof(mask);
+			
+			if ((flags&heights_flag)==0) {
+			
+				//	The height map will be computed
+				//	once the sections are loaded
+				std::memset(heights,0,sizeof(heights));
+				heights_pending=true;
+			
+			} else {
+			
+				if (static_cast<Word>(end-begin)<sizeof(heights)) return false;
+				
+				std::memcpy(heights,begin,sizeof(heights));
+				begin+=sizeof(heights);
+				heights_pending=false;
+			
+			}
+			
+			memory=0;
+			for (auto & section : sections) section.reset();
+			
+			//	If only the header is present, each
+			//	section is stored separately
+			if (begin==end) {
+			
+				pending=mask;
+				
+				return true;
+			
+			}
+			
+			//	Otherwise the sections follow
+			//	the header
+			for (Word i=0;i<16;++i) {
+			
+				if ((mask&(static_cast<UInt16>(1)<<i))==0) continue;
+				
+				auto & section=sections[i];
+				section=std::make_shared<ColumnSection>();
+				if (!section->Deserialize(begin,end)) return false;
+				
+				memory+=section->Memory();
+			
+			}
+			
+			//	The entire buffer should have
+			//	been consumed
+			if (begin!=end) return false;
+			
+			//	This format is no longer written,
+			//	the whole column must be saved in
+			//	the current format
+			pending=0;
+			dirty=true;
+			dirty_sections=std::numeric_limits<UInt16>::max();
+			
+			return true;
+		
+		}();
+		
+		//	Columns saved before sections were
+		//	introduced are a fixed size
+		if (!success && (buffer.Count()==legacy_size)) {
+		
+			pending=0;
+			
+			success=deserialize_legacy(buffer);
+		
+		}
+		
+		//	Sections were replaced without regard
+		//	for threads reading without the lock,
+		//	there can be none while a column is
+		//	loading
+		publish();
+		
+		return success;
+	
+	}
+	
+	
+	bool ColumnContainer::DeserializeSection (Word i, const Vector<Byte> & buffer) {
+	
+		const Byte * begin=buffer.begin();
+		const Byte * end=buffer.end();
+		
+		cache.Destroy();
+		
+		auto section=std::make_shared<ColumnSection>();
+		bool success=section->Deserialize(begin,end) && (begin==end);
+		
+		replace(i,success ? std::move(section) : std::shared_ptr<ColumnSection>());
+		
+		return success;
+	
+	}
+	
+	
+	bool ColumnContainer::deserialize_legacy (const Vector<Byte> & buffer) {
+	
+		const Byte * ptr=buffer.begin();
+		
+		memory=0;
+		for (auto & section : sections) section.reset();
+		
+		//	Writing each block builds the
+		//	height map
+		std::memset(heights,0,sizeof(heights));
+		heights_pending=false;
+		
+		for (Word i=0;i<(16*16*16*16);++i) {
+		
+			Block b;
+			std::memcpy(&b,ptr,sizeof(Block));
+			ptr+=sizeof(Block);
+			
+			Write(i,b);
+		
+		}
+		
+		std::memcpy(Biomes,ptr,sizeof(Biomes));
+		ptr+=sizeof(Biomes);
+		
+		Populated=*ptr!=0;
+		
+		//	This format is no longer written,
+		//	the whole column must be saved in
+		//	the current format
+		dirty=true;
+		dirty_sections=std::numeric_limits<UInt16>::max();
+		
+		//	The palettes built above may contain
+		//	entries which were subsequently
+		//	overwritten
+		Compact();
+		
+		return true;
 	
 	}
 	
@@ -696,9 +1354,16 @@ namespace MCPP {
 	}
 	
 	
+	UInt16 ColumnContainer::DirtySections () const noexcept {
+	
+		return dirty_sections;
+	
+	}
+	
+	
 	bool ColumnContainer::Dirty () const noexcept {
 	
-		return dirty;
+		return dirty || (dirty_sections!=0);
 	
 	}
 	
@@ -706,6 +1371,7 @@ namespace MCPP {
 	void ColumnContainer::Clean () noexcept {
 	
 		dirty=false;
+		dirty_sections=0;
 	
 	}
 	
@@ -723,13 +1389,6 @@ namespace MCPP {
 		);
 	
 	}
-	
-	
-	void * ColumnContainer::Get () noexcept {
-	
-		return this;
-	
-	}
 
 
 }
@@ -0,0 +1,153 @@
+#include <world/world.hpp>
+#include <functional>
+
+
+namespace MCPP {
+
+
+	constexpr Word ColumnMap::Shards;
+	
+	
+	static Word get_index (const ColumnID & id) noexcept {
+	
+		//	The shard's map uses the same hash,
+		//	so mix the high bits in to avoid
+		//	every column in a shard landing in
+		//	the same buckets
+		Word hash=std::hash<ColumnID>()(id);
+		hash^=hash>>16;
+		
+		return hash%ColumnMap::Shards;
+	
+	}
+	
+	
+	ColumnMap::Shard & ColumnMap::get_shard (const ColumnID & id) noexcept {
+	
+		return shards[get_index(id)];
+	
+	}
+	
+	
+	const ColumnMap::Shard & ColumnMap::get_shard (const ColumnID & id) const noexcept {
+	
+		return shards[get_index(id)];
+	
+	}
+	
+	
+	ColumnContainer * ColumnMap::Get (ColumnID id, bool create) {
+	
+		auto & shard=get_shard(id);
+		
+		//	Most lookups are of columns which
+		//	are already loaded, so only a read
+		//	lock is acquired at first
+		auto retr=shard.Lock.Read([&] () -> ColumnContainer * {
+		
+			auto iter=shard.Map.find(id);
+			if (iter==shard.Map.end()) return nullptr;
+			
+			//	We must acquire interest in the
+			//	column before releasing the lock
+			//	to prevent it from being spuriously
+			//	unloaded
+			auto retr=iter->second.get();
+			retr->Interested();
+			
+			return retr;
+		
+		});
+		
+		if ((retr!=nullptr) || !create) return retr;
+		
+		return shard.Lock.Write([&] () -> ColumnContainer * {
+		
+			//	The column may have been created
+			//	after the read lock was released
+			auto iter=shard.Map.find(id);
+			if (iter==shard.Map.end()) {
+			
+				//	Create a new column
+				std::unique_ptr<ColumnContainer> column(new ColumnContainer(id));
+				
+				//	Insert it
+				iter=shard.Map.emplace(
+					id,
+					std::move(column)
+				).first;
+			
+			}
+			
+			auto retr=iter->second.get();
+			retr->Interested();
+			
+			return retr;
+		
+		});
+	
+	}
+	
+	
+	void ColumnMap::EndInterest (ColumnID id) noexcept {
+	
+		auto & shard=get_shard(id);
+		
+		shard.Lock.Read([&] () {
+		
+			//	Releasing interest is only relevant
+			//	if the column-in-question actually
+			//	is loaded
+			
+			auto iter=shard.Map.find(id);
+			if (iter!=shard.Map.end()) iter->second->EndInterest();
+		
+		});
+	
+	}
+	
+	
+	std::unique_ptr<ColumnContainer> ColumnMap::Remove (ColumnContainer & column) {
+	
+		auto & shard=get_shard(column.ID());
+		
+		return shard.Lock.Write([&] () {
+		
+			std::unique_ptr<ColumnContainer> retr;
+		
+			//	Interest could have been acquired
+			//	between checking and acquiring
+			//	the lock, so check again
+			if (column.CanUnload()) {
+			
+				auto iter=shard.Map.find(column.ID());
+				
+				retr=std::move(iter->second);
+				
+				shard.Map.erase(iter);
+			
+			}
+			
+			return retr;
+		
+		});
+	
+	}
+	
+	
+	Vector<ColumnContainer *> ColumnMap::Snapshot () const {
+	
+		Vector<ColumnContainer *> retr;
+		
+		for (const auto & shard : shards) shard.Lock.Read([&] () {
+		
+			for (const auto & pair : shard.Map) retr.Add(pair.second.get());
+		
+		});
+		
+		return retr;
+	
+	}
+
+
+}
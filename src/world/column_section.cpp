@@ -0,0 +1,409 @@
+#include <world/world.hpp>
+#include <cstring>
+#include <limits>
+
+
+namespace MCPP {
+
+
+	constexpr Word ColumnSection::Count;
+	
+	
+	static constexpr Word bits_per_word=std::numeric_limits<UInt64>::digits;
+	
+	
+	//	Determines the number of words required
+	//	to store Count indices of a certain width
+	static Word words (Word bits) noexcept {
+	
+		if (bits==0) return 0;
+		
+		return ColumnSection::Count/(bits_per_word/bits);
+	
+	}
+	
+	
+	//	Determines the smallest index width
+	//	which can address a palette of a
+	//	certain size
+	static Word bits_for (Word count) noexcept {
+	
+		Word bits=0;
+		while ((static_cast<Word>(1)<<bits)<count) bits=(bits==0) ? 1 : (bits*2);
+		
+		return bits;
+	
+	}
+	
+	
+	//	Packs Count indices of a certain width,
+	//	the index of each block being determined
+	//	by a callback
+	template <typename T>
+	static std::unique_ptr<std::atomic<UInt64> []> pack (Word bits, T && index) {
+	
+		Word per=bits_per_word/bits;
+		Word count=words(bits);
+		std::unique_ptr<std::atomic<UInt64> []> retr(new std::atomic<UInt64> [count]);
+		for (Word i=0;i<count;++i) {
+		
+			UInt64 word=0;
+			for (Word j=0;j<per;++j) word|=static_cast<UInt64>(index((i*per)+j))<<(j*bits);
+			
+			retr[i].store(word,std::memory_order_relaxed);
+		
+		}
+		
+		return retr;
+	
+	}
+	
+	
+	ColumnSection::ColumnSection () : bits(0), non_air(0), extended(0) {
+	
+		palette.Add(Block());
+	
+	}
+	
+	
+	ColumnSection::ColumnSection (const ColumnSection & other)
+		:	palette(other.palette),
+			bits(other.bits),
+			non_air(other.non_air),
+			extended(other.extended)
+	{
+	
+		if (bits==0) return;
+		
+		Word count=words(bits);
+		indices=std::unique_ptr<std::atomic<UInt64> []>(new std::atomic<UInt64> [count]);
+		for (Word i=0;i<count;++i) indices[i].store(
+			other.indices[i].load(std::memory_order_relaxed),
+			std::memory_order_relaxed
+		);
+	
+	}
+	
+	
+	void ColumnSection::tally (Block block, bool add) noexcept {
+	
+		auto type=block.GetType();
+		if (type==0) return;
+		
+		if (add) ++non_air;
+		else --non_air;
+		
+		if (type<=std::numeric_limits<Byte>::max()) return;
+		
+		if (add) ++extended;
+		else --extended;
+	
+	}
+	
+	
+	Word ColumnSection::get_index (Word offset) const noexcept {
+	
+		Word per=bits_per_word/bits;
+		UInt64 mask=(static_cast<UInt64>(1)<<bits)-1;
+		
+		return static_cast<Word>(
+			(indices[offset/per].load(std::memory_order_acquire)>>((offset%per)*bits))&mask
+		);
+	
+	}
+	
+	
+	void ColumnSection::set_index (Word offset, Word index) noexcept {
+	
+		Word per=bits_per_word/bits;
+		Word shift=(offset%per)*bits;
+		UInt64 mask=((static_cast<UInt64>(1)<<bits)-1)<<shift;
+		
+		//	Only the writer stores words, so this
+		//	needn't be a read-modify-write
+		auto & word=indices[offset/per];
+		word.store(
+			(word.load(std::memory_order_relaxed)&~mask)|((static_cast<UInt64>(index)<<shift)&mask),
+			std::memory_order_release
+		);
+	
+	}
+	
+	
+	void ColumnSection::resize (Word bits) {
+	
+		if (bits==this->bits) return;
+		
+		std::unique_ptr<std::atomic<UInt64> []> indices;
+		
+		//	Copy existing indices (if any) into
+		//	the new array
+		if (bits!=0) indices=pack(
+			bits,
+			[&] (Word i) {	return (this->bits==0) ? 0 : get_index(i);	}
+		);
+		
+		this->indices=std::move(indices);
+		this->bits=bits;
+	
+	}
+	
+	
+	Block ColumnSection::Get (Word offset) const noexcept {
+	
+		//	The palette's count may be changing
+		//	(see Fits), so it's not consulted
+		return palette.begin()[(bits==0) ? 0 : get_index(offset)];
+	
+	}
+	
+	
+	void ColumnSection::Set (Word offset, Block block) {
+	
+		auto before=Get(offset);
+		
+		//	Find this block in the palette
+		Word index=0;
+		for (;index<palette.Count();++index) if (palette[index]==block) break;
+		
+		if (index==palette.Count()) {
+		
+			//	Not in the palette, it must be
+			//	added.
+			//
+			//	Before the indices are widened, or
+			//	if the palette has grown larger than
+			//	the section, discard entries which
+			//	are no longer in use
+			if (
+				(index>=(static_cast<Word>(1)<<bits)) ||
+				(index>=Count)
+			) {
+			
+				Compact();
+				
+				index=palette.Count();
+			
+			}
+			
+			//	The indices may have to be widened
+			//	to address the new entry
+			if (index>=(static_cast<Word>(1)<<bits)) resize(bits_for(index+1));
+			
+			palette.Add(block);
+		
+		}
+		
+		if (bits!=0) set_index(offset,index);
+		
+		tally(before,false);
+		tally(block,true);
+	
+	}
+	
+	
+	bool ColumnSection::Fits (Block block) const noexcept {
+	
+		for (const auto & b : palette) if (b==block) return true;
+		
+		//	Adding an entry to the palette must
+		//	not reallocate it, widen the indices,
+		//	or compact the section (see Set)
+		Word index=palette.Count();
+		
+		return (
+			(index<palette.Capacity()) &&
+			(index<(static_cast<Word>(1)<<bits)) &&
+			(index<Count)
+		);
+	
+	}
+	
+	
+	void ColumnSection::Compact () {
+	
+		if (bits==0) return;
+		
+		//	Determine which palette entries
+		//	are actually in use
+		Vector<Word> map(palette.Count());
+		for (Word i=0;i<palette.Count();++i) map.Add(0);
+		for (Word i=0;i<Count;++i) map[get_index(i)]=1;
+		
+		//	Build the new palette, replacing
+		//	each used flag with the entry's
+		//	index in the new palette
+		Vector<Block> compacted;
+		for (Word i=0;i<palette.Count();++i) if (map[i]!=0) {
+		
+			map[i]=compacted.Count();
+			compacted.Add(palette[i]);
+		
+		}
+		
+		//	If nothing was discarded there's
+		//	nothing to do
+		if (compacted.Count()==palette.Count()) return;
+		
+		Word bits=bits_for(compacted.Count());
+		
+		std::unique_ptr<std::atomic<UInt64> []> indices;
+		if (bits!=0) indices=pack(
+			bits,
+			[&] (Word i) {	return map[get_index(i)];	}
+		);
+		
+		palette=std::move(compacted);
+		this->indices=std::move(indices);
+		this->bits=bits;
+	
+	}
+	
+	
+	bool ColumnSection::IsAir (Block air) const noexcept {
+	
+		for (const auto & b : palette) if (b!=air) return false;
+		
+		return true;
+	
+	}
+	
+	
+	bool ColumnSection::IsEmpty () const noexcept {
+	
+		return non_air==0;
+	
+	}
+	
+	
+	bool ColumnSection::RequiresAdd () const noexcept {
+	
+		return extended!=0;
+	
+	}
+	
+	
+	Word ColumnSection::Memory () const noexcept {
+	
+		return sizeof(ColumnSection)+(palette.Capacity()*sizeof(Block))+(words(bits)*sizeof(UInt64));
+	
+	}
+	
+	
+	void ColumnSection::Serialize (Vector<Byte> & buffer) const {
+	
+		UInt16 count=static_cast<UInt16>(palette.Count());
+		Byte bits=static_cast<Byte>(this->bits);
+		Word palette_size=palette.Count()*sizeof(Block);
+		Word indices_size=words(this->bits)*sizeof(UInt64);
+		
+		Word after=buffer.Count()+sizeof(count)+palette_size+sizeof(bits)+indices_size;
+		if (buffer.Capacity()<after) buffer.SetCapacity(after);
+		
+		Byte * ptr=buffer.end();
+		std::memcpy(ptr,&count,sizeof(count));
+		ptr+=sizeof(count);
+		std::memcpy(ptr,palette.begin(),palette_size);
+		ptr+=palette_size;
+		*(ptr++)=bits;
+		for (Word i=0;i<words(this->bits);++i) {
+		
+			UInt64 word=indices[i].load(std::memory_order_relaxed);
+			std::memcpy(ptr,&word,sizeof(word));
+			ptr+=sizeof(word);
+		
+		}
+		
+		buffer.SetCount(after);
+	
+	}
+	
+	
+	bool ColumnSection::Deserialize (const Byte * & begin, const Byte * end) {
+	
+		UInt16 count;
+		if (static_cast<Word>(end-begin)<sizeof(count)) return false;
+		std::memcpy(&count,begin,sizeof(count));
+		
+		//	There must be at least one palette
+		//	entry, and there can never be more
+		//	than one entry beyond the number
+		//	of blocks (see Set)
+		if ((count==0) || (count>(Count+1))) return false;
+		
+		Word palette_size=count*sizeof(Block);
+		if (static_cast<Word>(end-begin)<(sizeof(count)+palette_size+sizeof(Byte))) return false;
+		
+		Word bits=begin[sizeof(count)+palette_size];
+		
+		//	Width must be a power of two which
+		//	divides a word evenly, and must be
+		//	able to address the entire palette
+		if (!(
+			(bits==0) ||
+			(bits==1) ||
+			(bits==2) ||
+			(bits==4) ||
+			(bits==8) ||
+			(bits==16)
+		)) return false;
+		if (count>(static_cast<Word>(1)<<bits)) return false;
+		
+		Word indices_size=words(bits)*sizeof(UInt64);
+		Word size=sizeof(count)+palette_size+sizeof(Byte)+indices_size;
+		if (static_cast<Word>(end-begin)<size) return false;
+		
+		Vector<Block> palette(count);
+		for (Word i=0;i<count;++i) {
+		
+			Block b;
+			std::memcpy(&b,begin+sizeof(count)+(i*sizeof(Block)),sizeof(Block));
+			
+			palette.Add(b);
+		
+		}
+		
+		std::unique_ptr<std::atomic<UInt64> []> indices;
+		if (bits!=0) {
+		
+			Word n=words(bits);
+			const Byte * ptr=begin+sizeof(count)+palette_size+sizeof(Byte);
+			indices=std::unique_ptr<std::atomic<UInt64> []>(new std::atomic<UInt64> [n]);
+			for (Word i=0;i<n;++i) {
+			
+				UInt64 word;
+				std::memcpy(&word,ptr,sizeof(word));
+				ptr+=sizeof(word);
+				
+				indices[i].store(word,std::memory_order_relaxed);
+			
+			}
+		
+		}
+		
+		this->palette=std::move(palette);
+		this->indices=std::move(indices);
+		this->bits=bits;
+		
+		//	Make sure every index refers to
+		//	an entry in the palette, and count
+		//	the blocks which aren't air
+		non_air=0;
+		extended=0;
+		for (Word i=0;i<Count;++i) {
+		
+			Word index=(bits==0) ? 0 : get_index(i);
+			if (index>=count) return false;
+			
+			tally(this->palette[index],true);
+		
+		}
+		
+		begin+=size;
+		
+		return true;
+	
+	}
+
+
+}
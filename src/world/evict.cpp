@@ -0,0 +1,253 @@
+#include <world/world.hpp>
+#include <server.hpp>
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+
+namespace MCPP {
+
+
+	static const String unload_str("Unloaded column {0}");
+	
+	
+	UInt64 World::now () const noexcept {
+	
+		return clock.ElapsedMilliseconds();
+	
+	}
+	
+	
+	std::unordered_map<ColumnContainer *,Tuple<UInt64,bool>> World::unloadable (const Vector<ColumnContainer *> & columns) {
+	
+		std::unordered_map<ColumnContainer *,Tuple<UInt64,bool>> retr;
+		
+		auto time=now();
+		
+		//	The number of bytes which will remain
+		//	loaded
+		Word total=0;
+		Word idle_count=0;
+		Word idle_bytes=0;
+		//	Columns which have not been released
+		//	for long enough, and when they were
+		//	released
+		Vector<Tuple<UInt64,ColumnContainer *>> candidates;
+		for (auto column : columns) {
+		
+			Word memory=column->Memory();
+			total+=memory;
+			
+			column->Acquire();
+			bool can_unload=column->CanUnload();
+			column->Release();
+			
+			if (!can_unload) continue;
+			
+			++idle_count;
+			idle_bytes+=memory;
+			
+			//	The column may have been released
+			//	since the time was taken
+			auto released=column->Released();
+			if (
+				(released<=time) &&
+				((time-released)>=unload_delay)
+			) {
+			
+				retr.emplace(column,Tuple<UInt64,bool>(released,false));
+				
+				total-=memory;
+			
+			} else {
+			
+				candidates.EmplaceBack(released,column);
+			
+			}
+		
+		}
+		
+		idle=idle_count;
+		idle_memory=idle_bytes;
+		
+		if ((memory_budget==0) || (total<=memory_budget)) return retr;
+		
+		//	Unload the columns which were released
+		//	least recently until the world is within
+		//	its budget
+		std::sort(
+			candidates.begin(),
+			candidates.end(),
+			[] (const Tuple<UInt64,ColumnContainer *> & a, const Tuple<UInt64,ColumnContainer *> & b) {	return a.Item<0>()<b.Item<0>();	}
+		);
+		
+		for (auto & t : candidates) {
+		
+			if (total<=memory_budget) break;
+			
+			retr.emplace(t.Item<1>(),Tuple<UInt64,bool>(t.Item<0>(),true));
+			
+			total-=t.Item<1>()->Memory();
+		
+		}
+		
+		return retr;
+	
+	}
+	
+	
+	bool World::unload (ColumnContainer & column, const Tuple<UInt64,bool> & chosen, bool clean) {
+	
+		//	If we unload, we keep the
+		//	pointer here, so that it's
+		//	not cleaned up before
+		//	we released the lock
+		std::unique_ptr<ColumnContainer> extend_lifetime;
+		//	Columns which are unloaded while
+		//	clean are cached, so that they
+		//	may be loaded again without the
+		//	backing store
+		Nullable<ColumnSnapshot> snapshot;
+		
+		column.Acquire();
+		
+		try {
+		
+			//	If the column has been released
+			//	again since it was chosen, it
+			//	was used in the meantime
+			if (
+				column.CanUnload() &&
+				(column.Released()==chosen.Item<0>()) &&
+				!(clean && column.Dirty())
+			) {
+			
+				extend_lifetime=world.Remove(column);
+				
+				auto state=column.GetState();
+				if (
+					extend_lifetime &&
+					!column.Dirty() &&
+					(
+						(state==ColumnState::Generated) ||
+						(state==ColumnState::Populated)
+					)
+				) snapshot.Construct(column.Snapshot());
+			
+			}
+		
+		} catch (...) {
+		
+			column.Release();
+			
+			throw;
+		
+		}
+		
+		column.Release();
+		
+		if (!extend_lifetime) return false;
+		
+		++unloaded;
+		if (chosen.Item<1>()) ++evicted;
+		
+		//	A cached copy of a column which
+		//	was not cached must not be loaded,
+		//	it may be out of date
+		if (snapshot.IsNull()) uncache_column(column.ID());
+		else cache_column(*snapshot);
+		
+		//	TODO: Fire event
+		
+		auto & server=Server::Get();
+		if (server.IsVerbose(verbose)) server.WriteLog(
+			String::Format(
+				unload_str,
+				column.ToString()
+			),
+			Service::LogType::Debug
+		);
+		
+		return true;
+	
+	}
+	
+	
+	bool World::begin_unloading (bool wait) {
+	
+		return maintaining_lock.Execute([&] () {
+		
+			if (maintaining) {
+			
+				if (!wait) return false;
+				
+				do maintaining_wait.Sleep(maintaining_lock);
+				while (maintaining);
+			
+			}
+			
+			maintaining=true;
+			
+			return true;
+		
+		});
+	
+	}
+	
+	
+	void World::end_unloading () noexcept {
+	
+		maintaining_lock.Execute([&] () {
+		
+			maintaining=false;
+			
+			maintaining_wait.WakeAll();
+		
+		});
+	
+	}
+	
+	
+	void World::evict () {
+	
+		auto & server=Server::Get();
+		
+		try {
+		
+			//	Maintenance unloads columns itself,
+			//	and may wait on the backing store
+			//	for some time, so this pass is
+			//	skipped rather than waiting for it
+			if (begin_unloading(false)) {
+			
+				auto guard=AtExit([&] () {	end_unloading();	});
+			
+				//	Columns are only unloaded by the
+				//	thread which is unloading, so
+				//	these pointers remain valid
+				auto columns=world.Snapshot();
+				
+				//	Dirty columns must wait for
+				//	maintenance to save them
+				for (auto & pair : unloadable(columns)) unload(*pair.first,pair.second,true);
+			
+			}
+			
+			//	Queue up next iteration
+			server.Pool().Enqueue(
+				evict_interval,
+				[this] () mutable {	evict();	}
+			);
+		
+		} catch (...) {
+		
+			try {	server.Panic(std::current_exception());	} catch (...) {	}
+			
+			throw;
+		
+		}
+	
+	}
+
+
+}
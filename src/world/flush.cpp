@@ -0,0 +1,66 @@
+#include <world/world.hpp>
+#include <server.hpp>
+#include <exception>
+#include <utility>
+
+
+namespace MCPP {
+
+
+	void World::add_changed (ColumnContainer & column) {
+	
+		changed_lock.Execute([&] () {
+		
+			//	Hold interest in the column so
+			//	it cannot be unloaded before its
+			//	changes are flushed
+			if (changed.insert(&column).second) column.Interested();
+		
+		});
+	
+	}
+	
+	
+	void World::flush () {
+	
+		auto & server=Server::Get();
+		
+		try {
+		
+			//	Light is updated first, so that
+			//	columns which are resent have
+			//	up to date light
+			update_light();
+		
+			//	Take all columns which have
+			//	changes buffered
+			std::unordered_set<ColumnContainer *> columns;
+			changed_lock.Execute([&] () {	std::swap(columns,changed);	});
+			
+			for (auto column : columns) {
+			
+				//	Don't leak interest
+				auto guard=AtExit([&] () {	column->EndInterest();	});
+				
+				column->Flush();
+			
+			}
+			
+			//	Queue up next iteration
+			server.Pool().Enqueue(
+				flush_interval,
+				[this] () mutable {	flush();	}
+			);
+		
+		} catch (...) {
+		
+			try {	server.Panic(std::current_exception());	} catch (...) {	}
+			
+			throw;
+		
+		}
+	
+	}
+
+
+}
@@ -6,7 +6,43 @@ namespace MCPP {
 
 	WorldInfo World::GetInfo () const noexcept {
 	
-		Word num=lock.Execute([&] () {	return world.size();	});
+		Word num=0;
+		Word memory=0;
+		world.Enumerate([&] (const ColumnContainer & column) {
+		
+			++num;
+			memory+=column.Memory();
+		
+		});
+		
+		auto stage_info=[] (const Stage & stage) noexcept {
+		
+			return stage.Lock.Execute([&] () {
+			
+				return WorldStageInfo{
+					stage.Limit,
+					stage.Capacity,
+					stage.Running,
+					stage.Queue.Count(),
+					stage.MaxQueued,
+					Word(stage.Completed),
+					Word(stage.Overflowed),
+					UInt64(stage.Waiting),
+					UInt64(stage.Processing)
+				};
+			
+			});
+		
+		};
+		
+		Word cached;
+		Word cache_size;
+		cache_lock.Execute([&] () {
+		
+			cached=cache.size();
+			cache_size=this->cache_size;
+		
+		});
 		
 		return WorldInfo{
 			Word(maintenances),
@@ -21,11 +57,20 @@ namespace MCPP {
 			Word(populated),
 			UInt64(populate_time),
 			num,
-			num*(
-				sizeof(ColumnContainer::Blocks)+
-				sizeof(ColumnContainer::Biomes)+
-				sizeof(ColumnContainer::Populated)
-			)
+			memory,
+			Word(cache_hits),
+			cached,
+			cache_size,
+			memory_budget,
+			Word(idle),
+			Word(idle_memory),
+			Word(evicted),
+			{
+				stage_info(load_stage),
+				stage_info(generate_stage),
+				stage_info(populate_stage),
+				stage_info(send_stage)
+			}
 		};
 	
 	}
@@ -46,6 +46,31 @@ static const String count_label("Loaded Columns: ");
 static const String memory_label("Memory Use: ");
 
 
+static const String cache_hits_label("Cache Hits: ");
+static const String cached_label("Cached Columns: ");
+static const String cache_memory_label("Cache Memory Use: ");
+
+
+static const String budget_label("Memory Budget: ");
+static const String unlimited("Unlimited");
+static const String idle_label("Idle Columns: ");
+static const String idle_memory_label("Idle Memory Use: ");
+static const String evicted_label("Evictions: ");
+
+
+static const String stage_names []={
+	String("Loading"),
+	String("Generating"),
+	String("Populating"),
+	String("Sending")
+};
+static const String stage_template("{0} Stage: ");
+static const String stage_running_template("{0}/{1} running, ");
+static const String stage_queued_template("{0}/{1} queued (peak {2}), ");
+static const String stage_completed_template("{0} completed, {1} overflowed, ");
+static const String stage_latency_template("{0} waiting, {1} processing (average)");
+
+
 static inline UInt64 avg (UInt64 t, Word n) noexcept {
 
 	return (n==0) ? 0 : (t/n);
@@ -63,6 +88,13 @@ static inline String ns (UInt64 n) {
 }
 
 
+static inline String limit (Word n) {
+
+	return (n==0) ? unlimited : String(n);
+
+}
+
+
 static const String mb("megabyte");
 static const String mb_p("megabytes");
 static const String kb("kilobyte");
@@ -279,8 +311,89 @@ class WorldInfoProvider : public Module, public InformationProvider {
 					<<	ChatStyle::Bold
 					<<	memory_label
 					<<	ChatFormat::Pop
-					<<	memory_format(info.Size);
+					<<	memory_format(info.Size)
+					<<	Newline
+					
+					//	Cache of recently unloaded
+					//	columns
+					<<	ChatStyle::Bold
+					<<	cache_hits_label
+					<<	ChatFormat::Pop
+					<<	info.CacheHits
+					<<	Newline
+					<<	ChatStyle::Bold
+					<<	cached_label
+					<<	ChatFormat::Pop
+					<<	info.Cached
+					<<	Newline
+					<<	ChatStyle::Bold
+					<<	cache_memory_label
+					<<	ChatFormat::Pop
+					<<	memory_format(info.CacheSize)
+					<<	Newline
 					
+					//	Memory budget and the columns
+					//	which may be unloaded
+					<<	ChatStyle::Bold
+					<<	budget_label
+					<<	ChatFormat::Pop
+					<<	((info.MemoryBudget==0) ? unlimited : memory_format(info.MemoryBudget))
+					<<	Newline
+					<<	ChatStyle::Bold
+					<<	idle_label
+					<<	ChatFormat::Pop
+					<<	info.Idle
+					<<	Newline
+					<<	ChatStyle::Bold
+					<<	idle_memory_label
+					<<	ChatFormat::Pop
+					<<	memory_format(info.IdleSize)
+					<<	Newline
+					<<	ChatStyle::Bold
+					<<	evicted_label
+					<<	ChatFormat::Pop
+					<<	info.Evicted;
+			
+			//	The stages through which columns
+			//	pass as they are prepared
+			for (Word i=0;i<(sizeof(info.Stages)/sizeof(*info.Stages));++i) {
+			
+				auto & stage=info.Stages[i];
+				
+				message	<<	Newline
+						<<	ChatStyle::Bold
+						<<	String::Format(stage_template,stage_names[i])
+						<<	ChatFormat::Pop
+						<<	String::Format(
+								stage_running_template,
+								stage.Running,
+								limit(stage.Limit)
+							)
+						<<	String::Format(
+								stage_queued_template,
+								stage.Queued,
+								limit(stage.Capacity),
+								stage.MaxQueued
+							)
+						<<	String::Format(
+								stage_completed_template,
+								stage.Completed,
+								stage.Overflowed
+							)
+						<<	String::Format(
+								stage_latency_template,
+								ns(avg(
+									stage.Waiting,
+									stage.Completed
+								)),
+								ns(avg(
+									stage.Processing,
+									stage.Completed
+								))
+							);
+			
+			}
+			
 		}
 
 
@@ -4,12 +4,14 @@
 namespace MCPP {
 
 
-	void World::Interested (ColumnID id, bool prepare) {
+	Promise<void> World::Interested (ColumnID id, bool prepare, Word priority) {
 	
 		//	This automatically acquires
 		//	interest
 		auto column=get_column(id);
 		
+		Promise<void> retr;
+		
 		if (prepare) {
 		
 			//	Column must be prepared -- fully
@@ -17,7 +19,7 @@ namespace MCPP {
 		
 			try {
 			
-				if (!column->WaitUntil(ColumnState::Populated)) process(*column);
+				retr=when_populated(*column,priority);
 			
 			} catch (...) {
 			
@@ -28,23 +30,20 @@ namespace MCPP {
 			
 			}
 			
+		} else {
+		
+			retr.Complete();
+		
 		}
+		
+		return retr;
 	
 	}
 	
 	
 	void World::EndInterest (ColumnID id) noexcept {
 	
-		lock.Execute([&] () {
-		
-			//	Releasing interest is only relevant
-			//	if the column-in-question actually
-			//	is loaded
-			
-			auto iter=world.find(id);
-			if (iter!=world.end()) iter->second->EndInterest();
-		
-		});
+		world.EndInterest(id);
 	
 	}
 
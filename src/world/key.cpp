@@ -4,24 +4,15 @@
 namespace MCPP {
 
 
-	static const String key_template("column_{0}_{1}_{2}");
-
-
-	String World::key (ColumnID id) const {
-	
-		return String::Format(
-			key_template,
-			id.X,
-			id.Z,
-			id.Dimension
-		);
-	
-	}
-	
-	
-	String World::key (const ColumnContainer & column) const {
+	ColumnKey World::key (ColumnID id, Byte section) noexcept {
 	
-		return key(column.ID());
+		ColumnKey retr;
+		retr.X=id.X;
+		retr.Z=id.Z;
+		retr.Dimension=id.Dimension;
+		retr.Section=section;
+		
+		return retr;
 	
 	}
 
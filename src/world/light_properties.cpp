@@ -0,0 +1,196 @@
+#include <world/world.hpp>
+#include <cstring>
+#include <initializer_list>
+
+
+namespace MCPP {
+
+
+	//	The number of distinct block types
+	//	which may be sent to clients, using
+	//	the "add" array
+	static const Word types=4096;
+	
+	
+	class LightPropertiesHelper {
+	
+	
+		private:
+		
+		
+			Byte opacity [types];
+			Byte emission [types];
+			
+			
+			void set (std::initializer_list<UInt16> list, Byte value, Byte * table) noexcept {
+			
+				for (auto type : list) table[type]=value;
+			
+			}
+		
+		
+		public:
+		
+		
+			inline Byte GetOpacity (UInt16 type) const noexcept {
+			
+				return (type<types) ? opacity[type] : 15;
+			
+			}
+			
+			
+			inline void SetOpacity (UInt16 type, Byte value) noexcept {
+			
+				if ((type<types) && (value<=15)) opacity[type]=value;
+			
+			}
+			
+			
+			inline Byte GetEmission (UInt16 type) const noexcept {
+			
+				return (type<types) ? emission[type] : 0;
+			
+			}
+			
+			
+			inline void SetEmission (UInt16 type, Byte value) noexcept {
+			
+				if ((type<types) && (value<=15)) emission[type]=value;
+			
+			}
+			
+			
+			LightPropertiesHelper () noexcept {
+			
+				//	Unless otherwise specified blocks
+				//	are opaque and do not emit light
+				std::memset(opacity,15,sizeof(opacity));
+				std::memset(emission,0,sizeof(emission));
+				
+				//	Vanilla blocks which let light
+				//	through
+				set(
+					{
+						0,		//	Air
+						6,		//	Sapling
+						10,		//	Flowing lava
+						11,		//	Lava
+						20,		//	Glass
+						26,		//	Bed
+						27,		//	Powered rail
+						28,		//	Detector rail
+						31,		//	Tall grass
+						32,		//	Dead bush
+						37,		//	Dandelion
+						38,		//	Flower
+						39,		//	Brown mushroom
+						40,		//	Red mushroom
+						50,		//	Torch
+						51,		//	Fire
+						54,		//	Chest
+						55,		//	Redstone wire
+						59,		//	Wheat
+						63,		//	Sign
+						64,		//	Wooden door
+						65,		//	Ladder
+						66,		//	Rail
+						68,		//	Wall sign
+						69,		//	Lever
+						70,		//	Stone pressure plate
+						71,		//	Iron door
+						72,		//	Wooden pressure plate
+						75,		//	Redstone torch (off)
+						76,		//	Redstone torch (on)
+						77,		//	Stone button
+						78,		//	Snow layer
+						83,		//	Sugar cane
+						85,		//	Fence
+						90,		//	Portal
+						92,		//	Cake
+						93,		//	Repeater (off)
+						94,		//	Repeater (on)
+						95,		//	Stained glass
+						96,		//	Trapdoor
+						101,	//	Iron bars
+						102,	//	Glass pane
+						104,	//	Pumpkin stem
+						105,	//	Melon stem
+						106,	//	Vines
+						107,	//	Fence gate
+						111,	//	Lily pad
+						113,	//	Nether brick fence
+						115,	//	Nether wart
+						116,	//	Enchantment table
+						117,	//	Brewing stand
+						119,	//	End portal
+						130,	//	Ender chest
+						131,	//	Tripwire hook
+						132,	//	Tripwire
+						140,	//	Flower pot
+						141,	//	Carrots
+						142,	//	Potatoes
+						143,	//	Wooden button
+						144,	//	Head
+						146,	//	Trapped chest
+						147,	//	Weighted pressure plate (light)
+						148,	//	Weighted pressure plate (heavy)
+						149,	//	Comparator (off)
+						150,	//	Comparator (on)
+						157,	//	Activator rail
+						160,	//	Stained glass pane
+						171,	//	Carpet
+						175		//	Double plant
+					},
+					0,
+					opacity
+				);
+				set({18,30,161},1,opacity);	//	Leaves and cobwebs
+				set({8,9,79},3,opacity);	//	Water and ice
+				
+				//	Vanilla blocks which emit light
+				set({10,11,51,89,91,119,124,138},15,emission);
+				set({50},14,emission);
+				set({62},13,emission);
+				set({90},11,emission);
+				set({74,94,150},9,emission);
+				set({76,130},7,emission);
+				set({39,117,120,122},1,emission);
+			
+			}
+	
+	
+	};
+	
+	
+	static LightPropertiesHelper light_properties;
+	
+	
+	Byte GetLightOpacity (UInt16 type) noexcept {
+	
+		return light_properties.GetOpacity(type);
+	
+	}
+	
+	
+	void SetLightOpacity (UInt16 type, Byte opacity) noexcept {
+	
+		light_properties.SetOpacity(type,opacity);
+	
+	}
+	
+	
+	Byte GetLightEmission (UInt16 type) noexcept {
+	
+		return light_properties.GetEmission(type);
+	
+	}
+	
+	
+	void SetLightEmission (UInt16 type, Byte emission) noexcept {
+	
+		light_properties.SetEmission(type,emission);
+	
+	}
+
+
+}
@@ -0,0 +1,534 @@
+#include <world/world.hpp>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+
+namespace MCPP {
+
+
+	//	The number of blocks in a column
+	static const Word column_size=ColumnSection::Count*16;
+	static const Byte max_light=15;
+	//	The directions in which light spreads,
+	//	the first of which is down
+	static const Int32 directions [6][3]={
+		{0,-1,0},
+		{0,1,0},
+		{-1,0,0},
+		{1,0,0},
+		{0,0,-1},
+		{0,0,1}
+	};
+	
+	
+	//	Determines how much light reaches a block
+	//	of a certain opacity from a neighbouring
+	//	block.
+	//
+	//	Skylight at full strength travelling down
+	//	is not diminished by transparent blocks.
+	static Byte attenuate (Byte light, Byte opacity, bool sky_down) noexcept {
+	
+		if (opacity>=max_light) return 0;
+		
+		if (sky_down && (light==max_light) && (opacity==0)) return max_light;
+		
+		Byte loss=(opacity==0) ? 1 : opacity;
+		
+		return (light>loss) ? static_cast<Byte>(light-loss) : 0;
+	
+	}
+	
+	
+	//	Spreads light within a single column,
+	//	every block which has light is treated
+	//	as a source
+	static void spread (Byte * levels, const Byte * opacity, Vector<Word> & queue, bool sky) {
+	
+		for (Word i=0;i<column_size;++i) if (levels[i]>1) queue.Add(i);
+		
+		for (Word head=0;head<queue.Count();++head) {
+		
+			Word offset=queue[head];
+			Byte level=levels[offset];
+			
+			auto visit=[&] (Word neighbour, bool down) {
+			
+				Byte l=attenuate(level,opacity[neighbour],sky && down);
+				if (l<=levels[neighbour]) return;
+				
+				levels[neighbour]=l;
+				queue.Add(neighbour);
+			
+			};
+			
+			Word x=offset%16;
+			Word z=(offset/16)%16;
+			Word y=offset/(16*16);
+			if (y!=0) visit(offset-(16*16),true);
+			if (y!=255) visit(offset+(16*16),false);
+			if (x!=0) visit(offset-1,false);
+			if (x!=15) visit(offset+1,false);
+			if (z!=0) visit(offset-16,false);
+			if (z!=15) visit(offset+16,false);
+		
+		}
+		
+		queue.Clear();
+	
+	}
+	
+	
+	void World::light (ColumnContainer & column) {
+	
+		bool has_skylight=HasSkylight(column.ID().Dimension);
+		
+		std::unique_ptr<Byte []> opacity(new Byte [column_size]);
+		std::unique_ptr<Byte []> light(new Byte [column_size]);
+		std::unique_ptr<Byte []> skylight(new Byte [column_size]);
+		
+		for (Word i=0;i<column_size;++i) {
+		
+			auto type=column.Read(i).GetType();
+			opacity[i]=GetLightOpacity(type);
+			light[i]=GetLightEmission(type);
+		
+		}
+		
+		//	Skylight travels straight down from
+		//	the top of the world until something
+		//	diminishes it
+		std::memset(skylight.get(),0,column_size);
+		if (has_skylight) for (Word i=0;i<(16*16);++i) {
+		
+			Byte level=max_light;
+			for (Word y=256;(y--)!=0;) {
+			
+				Word offset=(y*16*16)+i;
+				level=attenuate(level,opacity[offset],true);
+				skylight[offset]=level;
+			
+			}
+		
+		}
+		
+		Vector<Word> queue;
+		spread(light.get(),opacity.get(),queue,false);
+		if (has_skylight) spread(skylight.get(),opacity.get(),queue,true);
+		
+		for (Word i=0;i<column_size;++i) {
+		
+			auto block=column.Read(i);
+			auto lit=block;
+			lit.SetLight(light[i]);
+			lit.SetSkylight(skylight[i]);
+			
+			if (lit!=block) column.Write(i,lit);
+		
+		}
+	
+	}
+	
+	
+	//	Propagates light between loaded columns,
+	//	reading and writing one block at a time
+	//	under each column's lock.
+	//
+	//	Light is removed by a breadth first search
+	//	outward from changed blocks, which hands
+	//	the blocks at the edge of the darkened region
+	//	to a second breadth first search which
+	//	spreads light back in.  Both queues are flat,
+	//	and reused between passes.
+	class LightEngine {
+	
+	
+		private:
+		
+		
+			class Removal {
+			
+			
+				public:
+				
+				
+					BlockID ID;
+					Byte Level;
+			
+			
+			};
+			
+			
+			World & world;
+			//	Columns which have been retrieved, null
+			//	if the column is not loaded or has not
+			//	been generated.  Interest is held in each
+			//	of the non-null columns.
+			std::unordered_map<ColumnID,ColumnContainer *> columns;
+			//	Columns which exist but have not yet
+			//	been generated
+			std::unordered_set<ColumnID> generating;
+			Vector<Removal> decrease;
+			Vector<BlockID> increase;
+			
+			
+			ColumnContainer * get (const ColumnID & id) {
+			
+				auto iter=columns.find(id);
+				if (iter!=columns.end()) return iter->second;
+				
+				auto column=world.get_column(id,false);
+				
+				//	Columns which have not been generated
+				//	have no light to spread, they're lit
+				//	when they're generated
+				if (
+					(column!=nullptr) &&
+					(static_cast<Word>(column->GetState())<static_cast<Word>(ColumnState::Generated))
+				) {
+				
+					column->EndInterest();
+					column=nullptr;
+					
+					generating.insert(id);
+				
+				}
+				
+				try {
+				
+					columns.emplace(id,column);
+				
+				} catch (...) {
+				
+					if (column!=nullptr) column->EndInterest();
+					
+					throw;
+				
+				}
+				
+				return column;
+			
+			}
+			
+			
+			bool get (const BlockID & id, Block & block) {
+			
+				auto column=get(id.GetContaining());
+				if (column==nullptr) return false;
+				
+				block=column->GetBlock(id);
+				
+				return true;
+			
+			}
+			
+			
+			//	Only blocks which have been retrieved
+			//	may be set
+			void set (const BlockID & id, Byte level, bool sky) {
+			
+				columns[id.GetContaining()]->SetLight(id.GetOffset(),level,sky);
+			
+			}
+			
+			
+			static Byte level (Block block, bool sky) noexcept {
+			
+				return sky ? block.GetSkylight() : block.GetLight();
+			
+			}
+			
+			
+			//	The light a block has regardless of its
+			//	neighbours
+			static Byte source (const BlockID & id, Block block, bool sky) noexcept {
+			
+				if (!sky) return GetLightEmission(block.GetType());
+				
+				return (id.Y==255) ? attenuate(max_light,GetLightOpacity(block.GetType()),true) : 0;
+			
+			}
+			
+			
+			static bool neighbour (const BlockID & id, Word direction, BlockID & retr) noexcept {
+			
+				Int32 y=static_cast<Int32>(id.Y)+directions[direction][1];
+				if ((y<0) || (y>255)) return false;
+				
+				retr.X=id.X+directions[direction][0];
+				retr.Y=static_cast<Byte>(y);
+				retr.Z=id.Z+directions[direction][2];
+				retr.Dimension=id.Dimension;
+				
+				return true;
+			
+			}
+			
+			
+			static bool applies (SByte dimension, bool sky) noexcept {
+			
+				return !sky || HasSkylight(dimension);
+			
+			}
+			
+			
+			void remove () {
+			
+				for (Word head=0;head<decrease.Count();++head) {
+				
+					auto removal=decrease[head];
+					
+					for (Word d=0;d<6;++d) {
+					
+						BlockID id;
+						Block block;
+						if (!(
+							neighbour(removal.ID,d,id) &&
+							get(id,block)
+						)) continue;
+						
+						Byte l=level(block,sky);
+						if (l==0) continue;
+						
+						//	Light which came from the removed
+						//	light is removed, light which did
+						//	not must spread back in
+						if (!(
+							(l<removal.Level) ||
+							(sky && (d==0) && (l==max_light) && (removal.Level==max_light))
+						)) {
+						
+							increase.Add(id);
+							
+							continue;
+						
+						}
+						
+						set(id,0,sky);
+						decrease.Add(Removal{id,l});
+						
+						Byte s=source(id,block,sky);
+						if (s==0) continue;
+						
+						set(id,s,sky);
+						increase.Add(id);
+					
+					}
+				
+				}
+				
+				decrease.Clear();
+			
+			}
+			
+			
+			void add () {
+			
+				for (Word head=0;head<increase.Count();++head) {
+				
+					auto id=increase[head];
+					Block block;
+					if (!get(id,block)) continue;
+					
+					Byte l=level(block,sky);
+					if (l<=1) continue;
+					
+					for (Word d=0;d<6;++d) {
+					
+						BlockID n;
+						Block b;
+						if (!(
+							neighbour(id,d,n) &&
+							get(n,b)
+						)) continue;
+						
+						Byte nl=attenuate(l,GetLightOpacity(b.GetType()),sky && (d==0));
+						if (nl<=level(b,sky)) continue;
+						
+						set(n,nl,sky);
+						increase.Add(n);
+					
+					}
+				
+				}
+				
+				increase.Clear();
+			
+			}
+		
+		
+		public:
+		
+		
+			//	Whether skylight, rather than light,
+			//	is being propagated
+			bool sky;
+			
+			
+			LightEngine (World & world) noexcept : world(world), sky(false) {	}
+			
+			
+			~LightEngine () noexcept {
+			
+				for (auto & pair : columns) if (pair.second!=nullptr) pair.second->EndInterest();
+			
+			}
+			
+			
+			//	Updates the light around blocks which
+			//	have been changed
+			void Blocks (const Vector<BlockID> & blocks) {
+			
+				for (auto & id : blocks) {
+				
+					Block block;
+					if (!(
+						applies(id.Dimension,sky) &&
+						get(id,block)
+					)) continue;
+					
+					Byte l=level(block,sky);
+					if (l!=0) set(id,0,sky);
+					
+					decrease.Add(Removal{id,l});
+				
+				}
+				
+				remove();
+				
+				for (auto & id : blocks) {
+				
+					Block block;
+					if (!(
+						applies(id.Dimension,sky) &&
+						get(id,block)
+					)) continue;
+					
+					Byte s=source(id,block,sky);
+					if (s>level(block,sky)) set(id,s,sky);
+					
+					increase.Add(id);
+				
+				}
+				
+				add();
+			
+			}
+			
+			
+			//	Spreads light across the borders of
+			//	columns to and from their neighbours
+			void Borders (const Vector<ColumnID> & ids) {
+			
+				for (auto & id : ids) {
+				
+					if (!(
+						applies(id.Dimension,sky) &&
+						(get(id)!=nullptr)
+					)) continue;
+					
+					Int32 x=id.X*16;
+					Int32 z=id.Z*16;
+					
+					for (Word side=0;side<4;++side) {
+					
+						ColumnID other=id;
+						if (side==0) --other.X;
+						else if (side==1) ++other.X;
+						else if (side==2) --other.Z;
+						else ++other.Z;
+						
+						if (get(other)==nullptr) continue;
+						
+						for (Word y=0;y<256;++y) for (Int32 i=0;i<16;++i) {
+						
+							BlockID inside;
+							inside.Y=static_cast<Byte>(y);
+							inside.Dimension=id.Dimension;
+							inside.X=(side==0) ? x : ((side==1) ? (x+15) : (x+i));
+							inside.Z=(side==2) ? z : ((side==3) ? (z+15) : (z+i));
+							
+							BlockID outside=inside;
+							if (side==0) --outside.X;
+							else if (side==1) ++outside.X;
+							else if (side==2) --outside.Z;
+							else ++outside.Z;
+							
+							increase.Add(inside);
+							increase.Add(outside);
+						
+						}
+					
+					}
+				
+				}
+				
+				add();
+			
+			}
+			
+			
+			//	Determines whether a column exists but
+			//	was not generated when it was retrieved
+			bool Generating (const ColumnID & id) const {
+			
+				return generating.count(id)!=0;
+			
+			}
+	
+	
+	};
+	
+	
+	void World::relight (BlockID id) {
+	
+		relight_lock.Execute([&] () {	relight_blocks.Add(id);	});
+	
+	}
+	
+	
+	void World::relight (ColumnID id) {
+	
+		relight_lock.Execute([&] () {	relight_columns.Add(id);	});
+	
+	}
+	
+	
+	void World::update_light () {
+	
+		Vector<BlockID> blocks;
+		Vector<ColumnID> borders;
+		relight_lock.Execute([&] () {
+		
+			std::swap(blocks,relight_blocks);
+			std::swap(borders,relight_columns);
+		
+		});
+		
+		if ((blocks.Count()==0) && (borders.Count()==0)) return;
+		
+		LightEngine engine(*this);
+		
+		for (auto sky : {false,true}) {
+		
+			engine.sky=sky;
+			engine.Blocks(blocks);
+			engine.Borders(borders);
+		
+		}
+		
+		//	Columns which were still being generated
+		//	will be ready on a later flush
+		Vector<ColumnID> retry;
+		for (auto & id : borders) if (engine.Generating(id)) retry.Add(id);
+		
+		if (retry.Count()!=0) relight_lock.Execute([&] () {	for (auto & id : retry) relight_columns.Add(id);	});
+	
+	}
+
+
+}
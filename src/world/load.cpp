@@ -1,19 +1,27 @@
 #include <world/world.hpp>
 #include <server.hpp>
-#include <cstring>
+#include <exception>
+#include <utility>
 
 
 namespace MCPP {
 
 
-	ColumnState World::load (ColumnContainer & column) {
+	static const String end_load("Loaded {0} {1} - {2} bytes in {3}ns");
+	static const String populated_str("populated");
+	static const String generated_str("generated");
+	static const String end_load_miss("Attempted to load {0} but it was not present - took {1}ns");
+	static const String load_error("Error while loading {0}");
+	
+	
+	Nullable<Vector<ColumnKey>> World::load_header (ColumnContainer & column, const Nullable<Vector<Byte>> & buffer) {
+	
+		Nullable<Vector<ColumnKey>> retr;
 	
-		//	Attemt to retrieve data
-		auto buffer=Server::Get().Data().GetBinary(key(column));
 		//	If no data was retrieved from
 		//	the backing store, the column
 		//	will have to be generated
-		if (buffer.IsNull()) return ColumnState::Generating;
+		if (buffer.IsNull()) return retr;
 		
 		//	Decompress
 		auto decompressed=Inflate(
@@ -21,16 +29,42 @@ namespace MCPP {
 			buffer->end()
 		);
 		
-		//	If the data is an invalid length,
-		//	generate the column
-		if (decompressed.Count()!=ColumnContainer::Size) return ColumnState::Generating;
+		//	If the data is invalid, generate
+		//	the column
+		UInt16 pending;
+		if (!column.Deserialize(decompressed,pending)) return retr;
 		
-		//	Copy the decompressed data
-		std::memcpy(
-			column.Get(),
-			decompressed.begin(),
-			ColumnContainer::Size
-		);
+		//	Each section which is stored
+		//	separately must also be retrieved
+		retr.Construct();
+		for (Word i=0;i<16;++i) if ((pending&(static_cast<UInt16>(1)<<i))!=0) retr->Add(key(column.ID(),static_cast<Byte>(i)));
+		
+		return retr;
+	
+	}
+	
+	
+	ColumnState World::load_sections (ColumnContainer & column, const Vector<ColumnKey> & keys, const Vector<Nullable<Vector<Byte>>> & sections) {
+	
+		for (Word i=0;i<keys.Count();++i) {
+		
+			auto & section=sections[i];
+			if (
+				section.IsNull() ||
+				!column.DeserializeSection(
+					keys[i].Section,
+					Inflate(
+						section->begin(),
+						section->end()
+					)
+				)
+			) return ColumnState::Generating;
+		
+		}
+		
+		//	Columns saved before height maps
+		//	were stored must have them computed
+		column.EnsureHeights();
 		
 		//	The column was loaded, but what
 		//	stat was it in?
@@ -41,4 +75,278 @@ namespace MCPP {
 	}
 
 
+	ColumnState World::load (ColumnContainer & column) {
+	
+		//	Recently unloaded columns need
+		//	not be retrieved
+		auto cached=uncache_column(column.ID());
+		if (cached) return load_cached(column,*cached);
+		
+		auto & data=Server::Get().Data();
+	
+		//	Attemt to retrieve data
+		auto keys=load_header(column,data.GetColumn(key(column.ID())));
+		if (keys.IsNull()) return ColumnState::Generating;
+		
+		//	Retrieve all sections which are
+		//	stored separately at once
+		return load_sections(
+			column,
+			*keys,
+			(keys->Count()==0) ? Vector<Nullable<Vector<Byte>>>() : data.GetColumns(*keys)
+		);
+	
+	}
+	
+	
+	//	Any error leaves the world in an
+	//	inconsistent state and is therefore
+	//	irrecoverable
+	[[noreturn]]
+	static void load_failed (const ColumnContainer & column) noexcept {
+	
+		auto & server=Server::Get();
+		
+		try {
+		
+			server.WriteLog(
+				String::Format(
+					load_error,
+					column.ToString()
+				),
+				Service::LogType::Error
+			);
+		
+		//	We're already panicking,
+		//	can't do anything about this
+		} catch (...) {	}
+		
+		server.Panic(std::current_exception());
+	
+	}
+	
+	
+	//	Continues loading a column on the
+	//	thread pool, so that the backing
+	//	store's threads only ever perform
+	//	I/O
+	static void load_continue (ColumnContainer & column, std::function<void ()> callback) noexcept {
+	
+		try {
+		
+			Server::Get().Pool().Enqueue([&column,callback] () mutable {
+			
+				try {
+				
+					callback();
+				
+				} catch (...) {
+				
+					load_failed(column);
+				
+				}
+			
+			});
+		
+		} catch (...) {
+		
+			load_failed(column);
+		
+		}
+	
+	}
+	
+	
+	Promise<Vector<Nullable<Vector<Byte>>>> World::fetch (Vector<ColumnKey> keys) {
+	
+		auto & server=Server::Get();
+		
+		if (fetch_window==0) return server.Data().GetColumnsAsync(std::move(keys));
+		
+		Promise<Vector<Nullable<Vector<Byte>>>> retr;
+		
+		bool full=false;
+		bool schedule=false;
+		fetch_lock.Execute([&] () {
+		
+			fetch_count+=keys.Count();
+			
+			PendingFetch pending;
+			pending.Keys=std::move(keys);
+			pending.Result=retr;
+			fetches.Add(std::move(pending));
+			
+			if (fetch_count>=fetch_batch) {
+			
+				full=true;
+			
+			} else if (!fetch_scheduled) {
+			
+				fetch_scheduled=true;
+				schedule=true;
+			
+			}
+		
+		});
+		
+		if (full) fetch_pending(false);
+		else if (schedule) server.Pool().Enqueue(
+			fetch_window,
+			[this] () mutable {	fetch_pending(true);	}
+		);
+		
+		return retr;
+	
+	}
+	
+	
+	void World::fetch_pending (bool scheduled) {
+	
+		Vector<PendingFetch> batch;
+		fetch_lock.Execute([&] () {
+		
+			std::swap(batch,fetches);
+			fetch_count=0;
+			
+			//	A batch which was made because it
+			//	became full leaves the scheduled
+			//	batch to collect further retrievals
+			if (scheduled) fetch_scheduled=false;
+		
+		});
+		
+		if (batch.Count()==0) return;
+		
+		Vector<ColumnKey> keys;
+		for (auto & pending : batch) for (auto & key : pending.Keys) keys.Add(key);
+		
+		try {
+		
+			Server::Get().Data().GetColumnsAsync(std::move(keys)).Then([batch] (Promise<Vector<Nullable<Vector<Byte>>>> p) mutable {
+			
+				//	Each retrieval receives its
+				//	portion of the batch
+				try {
+				
+					auto results=p.Get();
+					
+					Word i=0;
+					for (auto & pending : batch) {
+					
+						Vector<Nullable<Vector<Byte>>> result(pending.Keys.Count());
+						for (Word j=0;j<pending.Keys.Count();++j) result.Add(std::move(results[i++]));
+						
+						pending.Result.Complete(std::move(result));
+					
+					}
+				
+				} catch (...) {
+				
+					for (auto & pending : batch) pending.Result.Fail(std::current_exception());
+				
+				}
+			
+			});
+		
+		} catch (...) {
+		
+			for (auto & pending : batch) pending.Result.Fail(std::current_exception());
+			
+			throw;
+		
+		}
+	
+	}
+	
+	
+	void World::load (ColumnContainer & column, std::function<void (ColumnState)> callback) {
+	
+		auto cached=uncache_column(column.ID());
+		if (cached) {
+		
+			load_continue(column,[this,&column,callback,cached] () mutable {	callback(load_cached(column,*cached));	});
+			
+			return;
+		
+		}
+	
+		Vector<ColumnKey> header;
+		header.Add(key(column.ID()));
+		
+		fetch(std::move(header)).Then([this,&column,callback] (Promise<Vector<Nullable<Vector<Byte>>>> p) mutable {
+		
+			load_continue(column,[this,&column,callback,p] () mutable {
+			
+				auto keys=load_header(column,p.Get()[0]);
+				if (keys.IsNull()) {
+				
+					callback(ColumnState::Generating);
+					
+					return;
+				
+				}
+				
+				if (keys->Count()==0) {
+				
+					callback(load_sections(column,*keys,Vector<Nullable<Vector<Byte>>>()));
+					
+					return;
+				
+				}
+				
+				//	Retrieve all sections which are
+				//	stored separately at once
+				fetch(*keys).Then([this,&column,callback,keys] (Promise<Vector<Nullable<Vector<Byte>>>> p) mutable {
+				
+					load_continue(column,[this,&column,callback,keys,p] () mutable {
+					
+						callback(load_sections(column,*keys,p.Get()));
+					
+					});
+				
+				});
+			
+			});
+		
+		});
+	
+	}
+	
+	
+	void World::record_load (const ColumnContainer & column, ColumnState state, UInt64 elapsed) {
+	
+		//	Stats
+		load_time+=elapsed;
+		++loaded;
+		
+		auto & server=Server::Get();
+		
+		//	Log if necessary
+		if (server.IsVerbose(verbose)) server.WriteLog(
+			(
+				(state==ColumnState::Generating)
+					//	We missed on the load --
+					//	nothing was loaded
+					?	String::Format(
+							end_load_miss,
+							column.ToString(),
+							elapsed
+						)
+					//	Load hit something -- we either
+					//	loaded a populated or generated
+					//	column
+					:	String::Format(
+							end_load,
+							column.ToString(),
+							(state==ColumnState::Populated) ? populated_str : generated_str,
+							column.Memory(),
+							elapsed
+						)
+			),
+			Service::LogType::Debug
+		);
+	
+	}
+
+
 }
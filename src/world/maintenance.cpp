@@ -1,5 +1,7 @@
 #include <world/world.hpp>
 #include <server.hpp>
+#include <exception>
+#include <memory>
 
 
 namespace MCPP {
@@ -7,105 +9,231 @@ namespace MCPP {
 
 	static const String maintenance_error("Error during world maintenance");
 	static const String end_maintenance("Finished world maintenance, took {0}ns, saved {1}, unloaded {2}");
-	static const String unload("Unloaded column {0}");
 
 
+	//	State shared between all the workers
+	//	performing a maintenance cycle.
+	//
+	//	Workers may start after the maintenance
+	//	cycle has ended (if the thread pool was
+	//	busy), so this is reference counted rather
+	//	than living on the stack of the thread
+	//	which started the cycle
+	class MaintenanceState {
+	
+	
+		public:
+		
+		
+			//	The columns to be maintained
+			Vector<ColumnContainer *> Columns;
+			//	The columns which shall be unloaded
+			//	once they have been saved
+			std::unordered_map<ColumnContainer *,Tuple<UInt64,bool>> Unload;
+			//	The index of the next column
+			//	which shall be maintained
+			std::atomic<Word> Next;
+			//	The number of columns which
+			//	have been saved/unloaded
+			std::atomic<Word> Saved;
+			std::atomic<Word> Unloaded;
+			
+			
+			//	The number of columns which have
+			//	not yet been maintained
+			Word Remaining;
+			//	The first error encountered by
+			//	a worker
+			std::exception_ptr Error;
+			Mutex Lock;
+			CondVar Wait;
+			
+			
+			MaintenanceState () noexcept : Remaining(0) {
+			
+				Next=0;
+				Saved=0;
+				Unloaded=0;
+			
+			}
+	
+	
+	};
+	
+	
 	void World::maintenance () {
 		
 		auto & server=Server::Get();
 	
 		bool is_verbose=server.IsVerbose(verbose);
-		Word this_saved=0;
-		Word this_unloaded=0;
 	
 		//	Start maintenance cycle timer
 		Timer timer(Timer::CreateAndStart());
 
-		//	Get a list of all the loaded
-		//	columns.
-		//
-		//	If we maintain the lock we'll
-		//	hold all other threads up, but
-		//	if we dispatch an asynchronous
-		//	callback per worker we could wind
-		//	up clogging the thread pool
-		//	waiting for synchronous I/O.
-		Vector<ColumnContainer *> columns;
-		lock.Execute([&] () {
+		auto state=std::make_shared<MaintenanceState>();
 		
-			columns=Vector<ColumnContainer *>(world.size());
+		//	Saves and, if possible, unloads
+		//	columns until there are none left
+		auto work=[this,state] () {
 		
-			for (auto & pair : world) columns.Add(pair.second.get());
+			auto & columns=state->Columns;
 			
-		});
-		
-		maintenance_lock.Execute([&] () {
-		
-			//	Loop and perform maintenance on
-			//	each column
-			for (auto column : columns) {
+			//	The previous column's save, each
+			//	worker has at most two saves in flight
+			//	so that the number of columns waiting
+			//	on the backing store is bounded by
+			//	the number of workers
+			Nullable<Promise<void>> previous;
+			auto wait=[&] () {
 			
-				//	Save
-				if (save(*column)) ++this_saved;
+				if (previous.IsNull()) return;
 				
-				//	See if we can unload
+				previous->Wait();
+				previous.Destroy();
+			
+			};
+		
+			for (;;) {
+			
+				Word i=state->Next++;
+				if (i>=columns.Count()) {
 				
-				bool did_unload=false;
+					wait();
+					
+					return;
 				
-				column->Acquire();
+				}
 				
-				//	If we unload, we keep the
-				//	pointer here, so that it's
-				//	not cleaned up before
-				//	we released the lock
-				std::unique_ptr<ColumnContainer> extend_lifetime;
+				auto column=columns[i];
 				
-				if (column->CanUnload()) {
+				//	Once the column has been saved
+				//	(or has failed to save) see if
+				//	it can be unloaded.
+				//
+				//	The column must not be unloaded
+				//	until the save is complete, or
+				//	it could be loaded again before
+				//	the backing store has the latest
+				//	version
+				auto done=[this,state,column] (Promise<bool> p) {
 				
-					lock.Execute([&] () {
+					try {
 					
-						//	Interest could have been acquired
-						//	between checking and acquiring
-						//	the lock, so check again
-						if (column->CanUnload()) {
+						if (p.Get()) ++state->Saved;
 						
-							did_unload=true;
-							
-							auto iter=world.find(column->ID());
-							
-							extend_lifetime=std::move(iter->second);
-							
-							world.erase(iter);
-						
-						}
-					
-					});
-					
-				}
-				
-				column->Release();
-				
-				if (did_unload) {
+						//	See if we can unload.
+						//
+						//	The column may have been modified
+						//	while it was being saved, in which
+						//	case unloading it would discard
+						//	those modifications, so it's only
+						//	unloaded if it's still clean, and
+						//	will be saved again next time
+						//	otherwise
+						auto iter=state->Unload.find(column);
+						if (
+							(iter!=state->Unload.end()) &&
+							unload(*column,iter->second,true)
+						) ++state->Unloaded;
 					
-					++unloaded;
-					++this_unloaded;
+					} catch (...) {
 					
-					//	TODO: Fire event
+						state->Lock.Execute([&] () {	if (!state->Error) state->Error=std::current_exception();	});
 					
-					if (is_verbose) server.WriteLog(
-						String::Format(
-							unload,
-							column->ToString()
-						),
-						Service::LogType::Debug
-					);
+					}
 					
+					state->Lock.Execute([&] () {	if (--state->Remaining==0) state->Wait.WakeAll();	});
+				
+				};
+				
+				//	Save without waiting for the
+				//	backing store, so that this
+				//	worker may serialize this column
+				//	while the previous column is
+				//	being written
+				Promise<bool> promise;
+				try {
+				
+					promise=save(*column);
+				
+				} catch (...) {
+				
+					promise=Promise<bool>();
+					promise.Fail(std::current_exception());
+				
 				}
+				
+				auto then=promise.Then(done);
+				
+				wait();
+				
+				previous.Construct(std::move(then));
 			
 			}
+		
+		};
+		
+		maintenance_lock.Execute([&] () {
+		
+			begin_unloading(true);
+			auto guard=AtExit([&] () {	end_unloading();	});
+			
+			//	Get a list of all the loaded
+			//	columns.
+			//
+			//	Columns are only unloaded by the
+			//	thread which is unloading, so these
+			//	pointers remain valid until they
+			//	are unloaded below
+			state->Columns=world.Snapshot();
+			state->Unload=unloadable(state->Columns);
+			state->Remaining=state->Columns.Count();
+			
+			//	Determine how many workers
+			//	shall perform maintenance,
+			//	this bounds the number of
+			//	columns being serialized
+			//	concurrently.
+			//
+			//	By default half the pool is used, so
+			//	that players are still served while
+			//	maintenance is performed, and never
+			//	the whole pool, since this thread is
+			//	one of the pool's workers
+			Word workers=server.Pool().Count();
+			Word concurrency=(maintenance_concurrency==0) ? (workers/2) : maintenance_concurrency;
+			if ((workers>1) && (concurrency>=workers)) concurrency=workers-1;
+			if (concurrency==0) concurrency=1;
+			if (concurrency>state->Columns.Count()) concurrency=state->Columns.Count();
+			
+			//	This thread is one of the
+			//	workers
+			for (Word i=1;i<concurrency;++i) server.Pool().Enqueue(work);
+			
+			work();
+			
+			//	Wait for the other workers
+			//	to finish, and for every
+			//	save to complete
+			state->Lock.Execute([&] () {	while (state->Remaining!=0) state->Wait.Sleep(state->Lock);	});
 			
 		});
 		
+		if (state->Error) {
+		
+			try {
+			
+				server.WriteLog(
+					maintenance_error,
+					Service::LogType::Error
+				);
+			
+			} catch (...) {	}
+			
+			std::rethrow_exception(state->Error);
+		
+		}
+		
 		auto elapsed=timer.ElapsedNanoseconds();
 		maintenance_time+=elapsed;
 		++maintenances;
@@ -115,8 +243,8 @@ namespace MCPP {
 			String::Format(
 				end_maintenance,
 				elapsed,
-				this_saved,
-				this_unloaded
+				Word(state->Saved),
+				Word(state->Unloaded)
 			),
 			Service::LogType::Debug
 		);
@@ -0,0 +1,241 @@
+#include <world/world.hpp>
+#include <server.hpp>
+#include <exception>
+#include <utility>
+
+
+namespace MCPP {
+
+
+	//	How often, in milliseconds, deferred sends
+	//	are retried while too many bytes are waiting
+	//	to be sent to a client
+	static const Word poll_interval=50;
+	
+	
+	void World::begin_pacing (const SmartPointer<Client> & client) {
+	
+		auto pacer=std::make_shared<Pacer>();
+		pacer->Tokens=static_cast<Int64>(send_burst);
+		pacer->Refilled=Timer::CreateAndStart();
+		pacer->Scheduled=false;
+		
+		pacers_lock.Execute([&] () {	pacers.emplace(client,std::move(pacer));	});
+	
+	}
+	
+	
+	std::shared_ptr<World::Pacer> World::get_pacer (const SmartPointer<Client> & client) {
+	
+		return pacers_lock.Execute([&] () {
+		
+			auto iter=pacers.find(client);
+			
+			return (iter==pacers.end()) ? std::shared_ptr<Pacer>() : iter->second;
+		
+		});
+	
+	}
+	
+	
+	bool World::can_send (const Client & client, Pacer & pacer) noexcept {
+	
+		if (
+			(send_high_water!=0) &&
+			(client.Queued()>=send_high_water)
+		) return false;
+		
+		if (send_rate==0) return true;
+		
+		//	Add tokens for the time which has
+		//	passed, up to the burst size
+		auto elapsed=static_cast<Double>(pacer.Refilled.ElapsedNanoseconds());
+		pacer.Refilled=Timer::CreateAndStart();
+		Double tokens=static_cast<Double>(pacer.Tokens)+((elapsed/1000000000.0)*send_rate);
+		pacer.Tokens=(tokens>send_burst) ? static_cast<Int64>(send_burst) : static_cast<Int64>(tokens);
+		
+		//	A column may overdraw the budget, so that
+		//	columns larger than the burst size may
+		//	still be sent
+		return pacer.Tokens>0;
+	
+	}
+	
+	
+	Word World::retry_after (const Pacer & pacer) const noexcept {
+	
+		if ((send_rate==0) || (pacer.Tokens>0)) return poll_interval;
+		
+		//	Wait until the budget is no longer
+		//	exhausted
+		auto ms=static_cast<Word>(((-pacer.Tokens)*1000)/static_cast<Int64>(send_rate))+1;
+		
+		return (ms<poll_interval) ? poll_interval : ms;
+	
+	}
+	
+	
+	void World::send_column (const SmartPointer<Client> & client, ColumnID id, const Vector<Byte> & buffer) {
+	
+		//	Pacers are only dropped once a client
+		//	disconnects, columns sent to it after
+		//	that would never be received
+		auto pacer=get_pacer(client);
+		if (!pacer) return;
+		
+		Word delay=pacer->Lock.Execute([&] () {
+		
+			//	If a send of this column is already
+			//	deferred, it's sent in the same order
+			//	but with the latest data
+			for (auto & t : pacer->Deferred) if (t.Item<0>()==id) {
+			
+				t.Item<1>()=buffer;
+				
+				return static_cast<Word>(0);
+			
+			}
+			
+			//	Columns are sent in order, so this
+			//	column may only be sent now if none
+			//	are deferred
+			if (
+				(pacer->Deferred.Count()==0) &&
+				can_send(*client,*pacer)
+			) {
+			
+				pacer->Tokens-=static_cast<Int64>(buffer.Count());
+				
+				const_cast<SmartPointer<Client> &>(client)->Send(buffer);
+				
+				return static_cast<Word>(0);
+			
+			}
+			
+			pacer->Deferred.EmplaceBack(id,buffer);
+			
+			if (pacer->Scheduled) return static_cast<Word>(0);
+			
+			pacer->Scheduled=true;
+			
+			return retry_after(*pacer);
+		
+		});
+		
+		if (delay!=0) Server::Get().Pool().Enqueue(
+			delay,
+			[this,client,pacer] () mutable {	pump(std::move(client),std::move(pacer));	}
+		);
+	
+	}
+	
+	
+	bool World::is_deferred (const SmartPointer<Client> & client, ColumnID id) {
+	
+		auto pacer=get_pacer(client);
+		if (!pacer) return false;
+		
+		return pacer->Lock.Execute([&] () {
+		
+			for (auto & t : pacer->Deferred) if (t.Item<0>()==id) return true;
+			
+			return false;
+		
+		});
+	
+	}
+	
+	
+	bool World::cancel_column (const SmartPointer<Client> & client, ColumnID id) {
+	
+		auto pacer=get_pacer(client);
+		if (!pacer) return false;
+		
+		return pacer->Lock.Execute([&] () {
+		
+			for (Word i=0;i<pacer->Deferred.Count();++i) if (pacer->Deferred[i].Item<0>()==id) {
+			
+				pacer->Deferred.Delete(i);
+				
+				return true;
+			
+			}
+			
+			return false;
+		
+		});
+	
+	}
+	
+	
+	void World::pump (SmartPointer<Client> client, std::shared_ptr<Pacer> pacer) {
+	
+		auto & server=Server::Get();
+		
+		try {
+		
+			Word delay=pacer->Lock.Execute([&] () {
+			
+				while (
+					(pacer->Deferred.Count()!=0) &&
+					can_send(*client,*pacer)
+				) {
+				
+					auto buffer=std::move(pacer->Deferred[0].Item<1>());
+					pacer->Deferred.Delete(0);
+					
+					pacer->Tokens-=static_cast<Int64>(buffer.Count());
+					
+					client->Send(std::move(buffer));
+				
+				}
+				
+				if (pacer->Deferred.Count()==0) {
+				
+					pacer->Scheduled=false;
+					
+					return static_cast<Word>(0);
+				
+				}
+				
+				return retry_after(*pacer);
+			
+			});
+			
+			if (delay!=0) server.Pool().Enqueue(
+				delay,
+				[this,client,pacer] () mutable {	pump(std::move(client),std::move(pacer));	}
+			);
+		
+		} catch (...) {
+		
+			try {	server.Panic(std::current_exception());	} catch (...) {	}
+			
+			throw;
+		
+		}
+	
+	}
+	
+	
+	void World::end_pacing (const SmartPointer<Client> & client) {
+	
+		std::shared_ptr<Pacer> pacer;
+		pacers_lock.Execute([&] () {
+		
+			auto iter=pacers.find(client);
+			if (iter==pacers.end()) return;
+			
+			pacer=std::move(iter->second);
+			pacers.erase(iter);
+		
+		});
+		
+		//	Any scheduled retry will find
+		//	nothing to send
+		if (pacer) pacer->Lock.Execute([&] () {	pacer->Deferred.Clear();	});
+	
+	}
+
+
+}
@@ -0,0 +1,184 @@
+#include <world/world.hpp>
+#include <server.hpp>
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+
+namespace MCPP {
+
+
+	bool World::later (const PendingColumn & a, const PendingColumn & b) noexcept {
+	
+		//	The standard library's heap algorithms
+		//	place the greatest element at the front,
+		//	so columns which should be processed
+		//	later are "less"
+		if (a.Priority==b.Priority) return a.Sequence>b.Sequence;
+		
+		return a.Priority>b.Priority;
+	
+	}
+	
+	
+	void World::dispatch (Stage & stage, Word priority, std::function<void (Timer)> callback) {
+	
+		Timer timer(Timer::CreateAndStart());
+		
+		//	0 if the column must wait, 1 if it may
+		//	be started on the thread pool, 2 if it
+		//	must be processed on this thread
+		Word action=stage.Lock.Execute([&] () {
+		
+			if ((stage.Limit==0) || (stage.Running<stage.Limit)) {
+			
+				++stage.Running;
+				
+				return static_cast<Word>(1);
+			
+			}
+			
+			if ((stage.Capacity==0) || (stage.Queue.Count()<stage.Capacity)) {
+			
+				PendingColumn pending;
+				pending.Priority=priority;
+				pending.Sequence=stage.Sequence++;
+				pending.Queued=timer;
+				pending.Callback=std::move(callback);
+				stage.Queue.Add(std::move(pending));
+				std::push_heap(stage.Queue.begin(),stage.Queue.end(),later);
+				
+				if (stage.Queue.Count()>stage.MaxQueued) stage.MaxQueued=stage.Queue.Count();
+				
+				return static_cast<Word>(0);
+			
+			}
+			
+			//	Too many columns are waiting, the
+			//	thread which is producing them must
+			//	process this one, slowing it down
+			++stage.Running;
+			
+			return static_cast<Word>(2);
+		
+		});
+		
+		if (action==0) return;
+		
+		if (action==2) {
+		
+			++stage.Overflowed;
+			
+			callback(Timer::CreateAndStart());
+			
+			return;
+		
+		}
+		
+		try {
+		
+			start(stage,timer,std::move(callback));
+		
+		} catch (...) {
+		
+			stage.Lock.Execute([&] () {	--stage.Running;	});
+			
+			throw;
+		
+		}
+	
+	}
+	
+	
+	void World::start (Stage & stage, Timer timer, std::function<void (Timer)> callback) {
+	
+		ready_lock.Execute([&] () mutable {
+		
+			ready.Add([&stage,timer,callback] () mutable {
+			
+				stage.Waiting+=timer.ElapsedNanoseconds();
+				
+				callback(Timer::CreateAndStart());
+			
+			});
+		
+		});
+		
+		//	A thread waiting for a column may have
+		//	processed this column by the time this
+		//	runs, in which case it does nothing
+		Server::Get().Pool().Enqueue([this] () mutable {	run_ready();	});
+	
+	}
+	
+	
+	bool World::run_ready () {
+	
+		std::function<void ()> callback;
+		if (!ready_lock.Execute([&] () mutable {
+		
+			if (ready.Count()==0) return false;
+			
+			callback=std::move(ready[0]);
+			ready.Delete(0);
+			
+			return true;
+		
+		})) return false;
+		
+		callback();
+		
+		return true;
+	
+	}
+	
+	
+	void World::complete (Stage & stage, Timer timer) noexcept {
+	
+		stage.Processing+=timer.ElapsedNanoseconds();
+		++stage.Completed;
+		
+		try {
+		
+			//	The waiting column with the lowest
+			//	priority takes this column's place,
+			//	unless this column was processed over
+			//	the limit
+			Nullable<PendingColumn> next;
+			stage.Lock.Execute([&] () {
+			
+				if (
+					(stage.Queue.Count()==0) ||
+					((stage.Limit!=0) && (stage.Running>stage.Limit))
+				) {
+				
+					--stage.Running;
+					
+					return;
+				
+				}
+				
+				std::pop_heap(stage.Queue.begin(),stage.Queue.end(),later);
+				next.Construct(std::move(stage.Queue[stage.Queue.Count()-1]));
+				stage.Queue.Delete(stage.Queue.Count()-1);
+			
+			});
+			
+			if (!next.IsNull()) start(
+				stage,
+				next->Queued,
+				std::move(next->Callback)
+			);
+		
+		//	A column which cannot be started
+		//	will never be prepared
+		} catch (...) {
+		
+			try {	Server::Get().Panic(std::current_exception());	} catch (...) {	}
+		
+		}
+	
+	}
+
+
+}
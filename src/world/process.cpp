@@ -6,13 +6,108 @@
 namespace MCPP {
 
 
-	static const String end_load("Loaded {0} {1} - {2} bytes in {3}ns");
-	static const String populated_str("populated");
-	static const String generated_str("generated");
-	static const String end_load_miss("Attempted to load {0} but it was not present - took {1}ns");
 	static const String end_generate("Generated {0} - took {1}ns");
 	static const String end_populate("Populated {0} - took {1}ns");
 	static const String processing_error("Error while processing {0}");
+	//	How long, in milliseconds, a thread waiting
+	//	on a column processed by another thread sleeps
+	//	when there are no tasks for it to run instead
+	static const Word wait_interval=10;
+	//	The number of columns which a thread waiting
+	//	on a column may be processing on behalf of
+	//	stages at once, each of which may itself be
+	//	waiting
+	static const Word max_yield_depth=16;
+	static thread_local Word yield_depth=0;
+	
+	
+	//	Logs that a column could not be
+	//	processed, and panics
+	static void fail (const ColumnContainer & column) noexcept {
+	
+		try {
+		
+			Server::Get().WriteLog(
+				String::Format(
+					processing_error,
+					column.ToString()
+				),
+				Service::LogType::Error
+			);
+		
+		//	We're already panicking,
+		//	can't do anything about this
+		} catch (...) {	}
+		
+		try {
+		
+			Server::Get().Panic(
+				std::current_exception()
+			);
+		
+		} catch (...) {	}
+	
+	}
+	
+	
+	void World::do_generate (ColumnContainer & column) {
+	
+		Timer timer(Timer::CreateAndStart());
+		
+		//	Generate column by invoking
+		//	world generator
+		generate(column);
+		
+		//	Light the column, and then
+		//	let light cross into and out
+		//	of its neighbours
+		light(column);
+		relight(column.ID());
+		
+		//	Stats
+		auto elapsed=timer.ElapsedNanoseconds();
+		generate_time+=elapsed;
+		++generated;
+		
+		//	Log if necessary
+		auto & server=Server::Get();
+		if (server.IsVerbose(verbose)) server.WriteLog(
+			String::Format(
+				end_generate,
+				column.ToString(),
+				elapsed
+			),
+			Service::LogType::Debug
+		);
+	
+	}
+	
+	
+	void World::do_populate (ColumnContainer & column, const WorldHandle * handle) {
+	
+		Timer timer(Timer::CreateAndStart());
+		
+		//	Populate column by invoking
+		//	populators
+		populate(column,handle);
+		
+		//	Stats
+		auto elapsed=timer.ElapsedNanoseconds();
+		populate_time+=elapsed;
+		++populated;
+		
+		//	Log if necessary
+		auto & server=Server::Get();
+		if (server.IsVerbose(verbose)) server.WriteLog(
+			String::Format(
+				end_populate,
+				column.ToString(),
+				elapsed
+			),
+			Service::LogType::Debug
+		);
+	
+	}
 
 
 	void World::process (ColumnContainer & column, const WorldHandle * handle) {
@@ -24,9 +119,6 @@ namespace MCPP {
 			//	The state the column is currently in
 			ColumnState curr=column.GetState();
 			
-			//	Are we logging debug information?
-			bool is_verbose=server.IsVerbose(verbose);
-			
 			bool dirty;
 			//	Process at least once -- this function
 			//	would not be called if processing did
@@ -52,35 +144,7 @@ namespace MCPP {
 						//	Load from backing store
 						curr=load(column);
 						
-						//	Stats
-						auto elapsed=timer.ElapsedNanoseconds();
-						load_time+=elapsed;
-						++loaded;
-						
-						//	Log if necessary
-						if (is_verbose) server.WriteLog(
-							(
-								(curr==ColumnState::Generating)
-									//	We missed on the load --
-									//	nothing was loaded
-									?	String::Format(
-											end_load_miss,
-											column.ToString(),
-											elapsed
-										)
-									//	Load hit something -- we either
-									//	loaded a populated or generated
-									//	column
-									:	String::Format(
-											end_load,
-											column.ToString(),
-											(curr==ColumnState::Populated) ? populated_str : generated_str,
-											ColumnContainer::Size,
-											elapsed
-										)
-							),
-							Service::LogType::Debug
-						);
+						record_load(column,curr,timer.ElapsedNanoseconds());
 						
 						//	We need to send the column to clients
 						//	if it has become populated
@@ -90,31 +154,10 @@ namespace MCPP {
 					
 					
 					//	GENERATING
-					case ColumnState::Generating:{
-					
-						Timer timer(Timer::CreateAndStart());
-						
-						//	Generate column by invoking
-						//	world generator
-						generate(column);
+					case ColumnState::Generating:
+						do_generate(column);
 						curr=ColumnState::Generated;
-						
-						//	Stats
-						auto elapsed=timer.ElapsedNanoseconds();
-						generate_time+=elapsed;
-						++generated;
-						
-						//	Log if necessary
-						if (is_verbose) server.WriteLog(
-							String::Format(
-								end_generate,
-								column.ToString(),
-								elapsed
-							),
-							Service::LogType::Debug
-						);
-						
-					}break;
+						break;
 					
 					
 					//	GENERATED
@@ -131,27 +174,8 @@ namespace MCPP {
 					//	POPULATING
 					case ColumnState::Populating:{
 					
-						Timer timer(Timer::CreateAndStart());
-						
-						//	Populate column by invoking
-						//	populators
-						populate(column,handle);
+						do_populate(column,handle);
 						curr=ColumnState::Populated;
-						
-						//	Stats
-						auto elapsed=timer.ElapsedNanoseconds();
-						populate_time+=elapsed;
-						++populated;
-						
-						//	Log if necessary
-						if (is_verbose) server.WriteLog(
-							String::Format(
-								end_populate,
-								column.ToString(),
-								elapsed
-							),
-							Service::LogType::Debug
-						);
 					
 					//	This scope is a neat
 					//	trick to avoid goto jumping
@@ -192,24 +216,269 @@ namespace MCPP {
 		//	is therefore irrecoverable
 		} catch (...) {
 		
-			try {
+			fail(column);
+		
+			throw;
+		
+		}
+	
+	}
+	
+	
+	Promise<void> World::when_populated (ColumnContainer & column, Word priority) {
+	
+		Promise<void> retr;
+		
+		if (!column.InvokeWhen(
+			ColumnState::Populated,
+			[retr] () mutable {	retr.Complete();	}
+		)) process_async(column,priority);
+		
+		return retr;
+	
+	}
+	
+	
+	void World::wait_until (ColumnContainer & column, ColumnState target, const WorldHandle * handle) {
+	
+		//	If nothing else is processing the
+		//	column, this thread must
+		if (!column.Check(target)) {
+		
+			process(column,handle);
 			
-				Server::Get().WriteLog(
-					String::Format(
-						processing_error,
-						column.ToString()
-					),
-					Service::LogType::Error
-				);
+			return;
+		
+		}
+		
+		//	Columns processed while waiting might
+		//	wait on columns this handle holds, or on
+		//	the population this handle is performing,
+		//	neither of which may proceed until they
+		//	return
+		bool may_yield=(
+			(yield_depth<max_yield_depth) &&
+			!(
+				(handle!=nullptr) &&
+				(handle->Exclusive() || (handle->populate!=0))
+			)
+		);
+		
+		while (static_cast<Word>(column.GetState())<static_cast<Word>(target)) {
+		
+			//	Rather than sleeping until the thread
+			//	processing the column finishes, process
+			//	other columns, so that a pool whose workers
+			//	are all waiting on columns may still
+			//	process those columns.
+			//
+			//	Only columns are processed, so nothing
+			//	which might acquire locks the caller holds,
+			//	or run for an arbitrarily long time, is run
+			//	on this thread.
+			if (may_yield) {
+			
+				++yield_depth;
+				bool ran;
+				try {
+				
+					ran=run_ready();
+				
+				} catch (...) {
+				
+					--yield_depth;
+					
+					throw;
+				
+				}
+				--yield_depth;
+				
+				if (ran) continue;
+			
+			}
 			
-			//	We're already panicking,
-			//	can't do anything about this
-			} catch (...) {	}
+			column.Sleep(target,wait_interval);
 		
-			Server::Get().Panic(
-				std::current_exception()
-			);
+		}
+	
+	}
+	
+	
+	void World::advance (ColumnContainer & column, ColumnState state, bool dirty, Word priority) {
+	
+		if (!column.SetState(
+			state,
+			dirty,
+			Server::Get().Pool()
+		)) process_async(column,priority);
+	
+	}
+	
+	
+	void World::process_send (ColumnContainer & column, bool dirty, Word priority) {
+	
+		column.Interested();
+		
+		try {
+		
+			dispatch(send_stage,priority,[this,&column,dirty,priority] (Timer timer) mutable {
+			
+				auto guard=AtExit([&] () {
+				
+					complete(send_stage,timer);
+					column.EndInterest();
+				
+				});
+				
+				try {
+				
+					column.Send();
+					
+					advance(column,ColumnState::Populated,dirty,priority);
+				
+				} catch (...) {
+				
+					fail(column);
+				
+				}
+			
+			});
+		
+		} catch (...) {
+		
+			column.EndInterest();
+			
+			throw;
+		
+		}
+	
+	}
+	
+	
+	void World::process_async (ColumnContainer & column, Word priority) {
+	
+		auto state=column.GetState();
 		
+		switch (state) {
+		
+			//	No processing needed at this
+			//	stage, just advance
+			case ColumnState::Generated:
+				//	This does not change the column's
+				//	logical state
+				advance(column,ColumnState::Populating,false,priority);
+				return;
+				
+			//	This shouldn't happen, but
+			//	if it does, we're done
+			case ColumnState::Populated:
+				return;
+				
+			default:
+				break;
+		
+		}
+		
+		//	The column must not be unloaded
+		//	while it waits for or is processed
+		//	by a stage
+		column.Interested();
+		
+		try {
+		
+			//	Errors are not propagated from the
+			//	stages, the world is irrecoverable
+			//	and the server has already panicked
+			if (state==ColumnState::Loading) dispatch(load_stage,priority,[this,&column,priority] (Timer timer) mutable {
+			
+				try {
+				
+					load(column,[this,&column,timer,priority] (ColumnState state) mutable {
+					
+						auto guard=AtExit([&] () {
+						
+							complete(load_stage,timer);
+							column.EndInterest();
+						
+						});
+						
+						try {
+						
+							record_load(column,state,timer.ElapsedNanoseconds());
+							
+							//	If the column was loaded populated,
+							//	it must be sent to attached clients
+							if (state==ColumnState::Populated) process_send(column,false,priority);
+							//	Loading does not change the column's
+							//	logical state
+							else advance(column,state,false,priority);
+						
+						} catch (...) {
+						
+							fail(column);
+						
+						}
+					
+					});
+				
+				} catch (...) {
+				
+					complete(load_stage,timer);
+					column.EndInterest();
+					fail(column);
+				
+				}
+			
+			});
+			else if (state==ColumnState::Generating) dispatch(generate_stage,priority,[this,&column,priority] (Timer timer) mutable {
+			
+				auto guard=AtExit([&] () {
+				
+					complete(generate_stage,timer);
+					column.EndInterest();
+				
+				});
+				
+				try {
+				
+					do_generate(column);
+					
+					advance(column,ColumnState::Generated,true,priority);
+				
+				} catch (...) {
+				
+					fail(column);
+				
+				}
+			
+			});
+			else dispatch(populate_stage,priority,[this,&column,priority] (Timer timer) mutable {
+			
+				auto guard=AtExit([&] () {
+				
+					complete(populate_stage,timer);
+					column.EndInterest();
+				
+				});
+				
+				try {
+				
+					do_populate(column,nullptr);
+					
+					process_send(column,true,priority);
+				
+				} catch (...) {
+				
+					fail(column);
+				
+				}
+			
+			});
+		
+		} catch (...) {
+		
+			column.EndInterest();
+			
 			throw;
 		
 		}
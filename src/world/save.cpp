@@ -1,8 +1,8 @@
 #include <world/world.hpp>
 #include <compression.hpp>
 #include <server.hpp>
-#include <cstring>
-#include <iterator>
+#include <exception>
+#include <memory>
 
 
 namespace MCPP {
@@ -10,9 +10,38 @@ namespace MCPP {
 
 	static const String save_failed("Failed saving {0} after {1}ns");
 	static const String end_save("Saved column {0} - {1} bytes in {2}ns");
+	
+	
+	//	Failing to save leaves the backing store
+	//	in an inconsistent state and is therefore
+	//	irrecoverable
+	[[noreturn]]
+	static void save_error (const ColumnContainer & column, Timer & timer) noexcept {
+	
+		auto & server=Server::Get();
+		
+		try {
+		
+			server.WriteLog(
+				String::Format(
+					save_failed,
+					column.ToString(),
+					timer.ElapsedNanoseconds()
+				),
+				Service::LogType::Error
+			);
+			
+		//	We don't care whether this
+		//	actually happens or not
+		} catch (...) {	}
+		
+		//	PANIC
+		server.Panic(std::current_exception());
+	
+	}
 
 
-	bool World::save (ColumnContainer & column) {
+	Promise<bool> World::save (ColumnContainer & column) {
 	
 		//	Start timer
 		Timer timer(Timer::CreateAndStart());
@@ -24,81 +53,156 @@ namespace MCPP {
 		
 			column.Release();
 			
-			return false;
+			Promise<bool> retr;
+			retr.Complete(false);
+			
+			return retr;
 		
 		}
 		
-		//	We copy the column so that
-		//	other threads do not have
-		//	to wait for the backing
-		//	store save operation
-		Byte buffer [ColumnContainer::Size];
-		memcpy(
-			buffer,
-			column.Get(),
-			ColumnContainer::Size
-		);
+		//	We take a snapshot of the column
+		//	so that other threads do not
+		//	have to wait for serialization
+		//	or the backing store save
+		//	operation.  Sections written
+		//	after this point are copied
+		//	by the column, the snapshot
+		//	continues to refer to the
+		//	sections as they are now.
+		//
+		//	Compact first so that stale
+		//	palette entries and sections
+		//	which are entirely air are
+		//	neither saved nor kept in
+		//	memory
+		Nullable<ColumnSnapshot> snapshot;
+		try {
+		
+			column.Compact();
+			
+			snapshot.Construct(column.Snapshot());
+		
+		} catch (...) {
+		
+			column.Release();
+			
+			throw;
+		
+		}
 		
 		//	Column is no longer dirty
 		column.Clean();
 		
 		column.Release();
 		
+		//	Any cached copy of this column is
+		//	now out of date
+		uncache_column(column.ID());
+		
 		auto & server=Server::Get();
 		
 		//	Perform save
+		Word bytes=0;
 		try {
 		
-			auto compressed=Deflate(
-				std::begin(buffer),
-				std::end(buffer)
-			);
-			server.Data().SaveBinary(
-				key(column),
-				compressed.begin(),
-				compressed.Count()
-			);
-		
-		} catch (...) {
-		
-			try {
-		
-				server.WriteLog(
+			//	Compressed data must outlive the
+			//	save operation, and must not move
+			//	once it has been referred to
+			auto buffers=std::make_shared<Vector<Vector<Byte>>>(static_cast<Word>(17));
+			Vector<ColumnData> pieces(17);
+			
+			auto add=[&] (Byte section, const Vector<Byte> * buffer) {
+			
+				ColumnData piece;
+				piece.Key=key(column.ID(),section);
+				piece.Pointer=nullptr;
+				piece.Length=0;
+				
+				if (buffer!=nullptr) {
+				
+					buffers->Add(
+						Deflate(
+							buffer->begin(),
+							buffer->end()
+						)
+					);
+					
+					auto & compressed=(*buffers)[buffers->Count()-1];
+					piece.Pointer=compressed.begin();
+					piece.Length=compressed.Count();
+					
+					bytes+=compressed.Count();
+				
+				}
+				
+				pieces.Add(piece);
+			
+			};
+			
+			//	Sections are saved before the
+			//	header which refers to them
+			//
+			//	Only sections which have been
+			//	modified are serialized, sections
+			//	which are now entirely air are
+			//	null and will be deleted
+			for (Word i=0;i<16;++i) {
+			
+				if ((snapshot->Dirty&(static_cast<UInt16>(1)<<i))==0) continue;
+				
+				auto buffer=snapshot->SerializeSection(i);
+				add(
+					static_cast<Byte>(i),
+					buffer.IsNull() ? nullptr : &(*buffer)
+				);
+			
+			}
+			
+			auto header=snapshot->SerializeHeader();
+			add(ColumnKey::Header,&header);
+			
+			//	Everything is saved at once, without
+			//	this thread waiting on the backing
+			//	store.  The compressed data is kept
+			//	alive by the continuation.
+			return server.Data().SaveColumnsAsync(std::move(pieces)).Then([this,&column,timer,bytes,buffers] (Promise<void> p) mutable {
+			
+				try {
+				
+					p.Get();
+				
+				} catch (...) {
+				
+					save_error(column,timer);
+				
+				}
+				
+				auto elapsed=timer.ElapsedNanoseconds();
+				save_time+=elapsed;
+				++saved;
+				
+				auto & server=Server::Get();
+				
+				//	Log if applicable
+				if (server.IsVerbose(verbose)) server.WriteLog(
 					String::Format(
-						save_failed,
+						end_save,
 						column.ToString(),
-						timer.ElapsedNanoseconds()
+						bytes,
+						elapsed
 					),
-					Service::LogType::Error
+					Service::LogType::Debug
 				);
 				
-			//	We don't care whether this
-			//	actually happens or not
-			} catch (...) {	}
-			
-			//	PANIC
-			server.Panic();
+				return true;
 			
-			throw;
+			});
 		
-		}
+		} catch (...) {
+		
+			save_error(column,timer);
 		
-		auto elapsed=timer.ElapsedNanoseconds();
-		save_time+=elapsed;
-		++saved;
-		
-		//	Log if applicable
-		if (server.IsVerbose(verbose)) server.WriteLog(
-			String::Format(
-				end_save,
-				column.ToString(),
-				ColumnContainer::Size,
-				elapsed
-			),
-			Service::LogType::Debug
-		);
-		
-		return true;
+		}
 	
 	}
 
@@ -0,0 +1,131 @@
+#include <world/world.hpp>
+#include <server.hpp>
+#include <exception>
+#include <memory>
+#include <random>
+#include <utility>
+
+
+namespace MCPP {
+
+
+	static const char * transaction_conflict_error="Transaction conflicted with another transaction";
+	//	The longest (in milliseconds) a transaction
+	//	waits before retrying after a conflict
+	static const Word max_backoff=16;
+	
+	
+	static Mutex generator_lock;
+	static std::minstd_rand generator;
+	
+	
+	//	Determines how long (in milliseconds) a
+	//	transaction waits before it's retried, so
+	//	that transactions which conflicted do not
+	//	immediately conflict again.
+	//
+	//	The wait is random, so that one of the
+	//	transactions is likely to finish before
+	//	the other retries, and its upper bound
+	//	doubles with each conflict
+	static Word backoff (Word conflicts) {
+	
+		Word bound=(conflicts>=5) ? max_backoff : (static_cast<Word>(1)<<(conflicts-1));
+		if (bound>max_backoff) bound=max_backoff;
+		
+		return generator_lock.Execute([&] () {	return static_cast<Word>(generator()%(bound+1));	});
+	
+	}
+	
+	
+	const char * TransactionConflict::what () const noexcept {
+	
+		return transaction_conflict_error;
+	
+	}
+	
+	
+	void World::transact (std::shared_ptr<std::function<void (const WorldHandle &)>> callback, BlockAccessStrategy access, Word conflicts, Promise<void> promise) noexcept {
+	
+		try {
+		
+			bool conflicted=false;
+			{
+			
+				auto handle=Begin(
+					BlockWriteStrategy::Transactional,
+					access
+				);
+				
+				try {
+				
+					(*callback)(handle);
+				
+				} catch (const TransactionConflict &) {
+				
+					//	The handle has already rolled
+					//	back, and released its columns
+					//	so the other transaction may
+					//	proceed
+					conflicted=true;
+				
+				} catch (...) {
+				
+					handle.Rollback();
+					
+					throw;
+				
+				}
+			
+			//	The handle commits as it's
+			//	destroyed
+			}
+			
+			if (!conflicted) {
+			
+				promise.Complete();
+				
+				return;
+			
+			}
+			
+			//	Rather than this thread sleeping
+			//	through the delay, the next attempt
+			//	is scheduled on the thread pool
+			++conflicts;
+			auto retry=[this,callback,access,conflicts,promise] () mutable {
+			
+				transact(std::move(callback),access,conflicts,std::move(promise));
+			
+			};
+			auto & pool=Server::Get().Pool();
+			Word delay=backoff(conflicts);
+			if (delay==0) pool.Enqueue(std::move(retry));
+			else pool.Enqueue(delay,std::move(retry));
+		
+		} catch (...) {
+		
+			promise.Fail(std::current_exception());
+		
+		}
+	
+	}
+	
+	
+	Promise<void> World::Transact (std::function<void (const WorldHandle &)> callback, BlockAccessStrategy access) {
+	
+		Promise<void> retr;
+		
+		transact(
+			std::make_shared<std::function<void (const WorldHandle &)>>(std::move(callback)),
+			access,
+			0,
+			retr
+		);
+		
+		return retr;
+	
+	}
+
+
+}
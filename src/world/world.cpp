@@ -18,6 +18,39 @@ namespace MCPP {
 	static const String seed_key("seed");
 	static const String maintenance_interval_key("maintenance_interval");
 	static const String type_key("world_type");
+	static const String flush_interval_key("block_flush_interval");
+	static const Word default_flush_interval=50;
+	static const String maintenance_concurrency_key("maintenance_concurrency");
+	static const Word default_maintenance_concurrency=0;
+	static const String send_rate_key("column_send_rate");
+	static const Word default_send_rate=2*1024*1024;
+	static const String send_burst_key("column_send_burst");
+	static const Word default_send_burst=512*1024;
+	static const String send_high_water_key("column_send_high_water");
+	static const Word default_send_high_water=256*1024;
+	static const String cache_budget_key("column_cache_size");
+	static const Word default_cache_budget=64*1024*1024;
+	static const String unload_delay_key("column_unload_delay");
+	static const Word default_unload_delay=30*1000;
+	static const String memory_budget_key("column_memory_budget");
+	static const Word default_memory_budget=512*1024*1024;
+	static const String evict_interval_key("column_evict_interval");
+	static const Word default_evict_interval=5*1000;
+	static const String load_concurrency_key("column_load_concurrency");
+	static const Word default_load_concurrency=64;
+	static const String fetch_window_key("column_load_batch_window");
+	static const Word default_fetch_window=2;
+	static const String fetch_batch_key("column_load_batch_size");
+	static const Word default_fetch_batch=64;
+	static const String generate_concurrency_key("column_generate_concurrency");
+	static const String populate_concurrency_key("column_populate_concurrency");
+	static const String send_concurrency_key("column_send_concurrency");
+	static const String load_queue_key("column_load_queue");
+	static const String generate_queue_key("column_generate_queue");
+	static const String populate_queue_key("column_populate_queue");
+	static const String send_queue_key("column_send_queue");
+	static const Word default_stage_queue=1024;
+	static const String stage_budget_warning("Column generate, populate, and send concurrency ({0}) is not less than the number of worker threads ({1}), columns being populated may wait on columns which cannot be generated");
 	static const String log_type("Set world type to \"{0}\"");
 
 
@@ -35,6 +68,29 @@ namespace MCPP {
 		generate_time=0;
 		populated=0;
 		populate_time=0;
+		cache_hits=0;
+		cache_size=0;
+		evicted=0;
+		idle=0;
+		idle_memory=0;
+		maintaining=false;
+		writers=0;
+		fetch_count=0;
+		fetch_scheduled=false;
+		for (auto stage : {&load_stage,&generate_stage,&populate_stage,&send_stage}) {
+		
+			stage->Sequence=0;
+			stage->Running=0;
+			stage->Limit=0;
+			stage->Capacity=0;
+			stage->MaxQueued=0;
+			stage->Completed=0;
+			stage->Overflowed=0;
+			stage->Waiting=0;
+			stage->Processing=0;
+		
+		}
+		clock=Timer::CreateAndStart();
 	
 	}
 	
@@ -86,8 +142,151 @@ namespace MCPP {
 		//	any module code
 		server.OnShutdown.Add([this] () mutable {	cleanup_events();	});
 		
+		//	Number of workers which shall
+		//	perform maintenance
+		maintenance_concurrency=server.Data().GetSetting(
+			maintenance_concurrency_key,
+			default_maintenance_concurrency
+		);
+		
+		//	Number of bytes of recently unloaded
+		//	columns which shall be kept in memory
+		cache_budget=server.Data().GetSetting(
+			cache_budget_key,
+			default_cache_budget
+		);
+		
+		//	Columns are kept loaded for a while
+		//	after they are no longer needed, so
+		//	long as they fit within the budget
+		unload_delay=server.Data().GetSetting(
+			unload_delay_key,
+			default_unload_delay
+		);
+		memory_budget=server.Data().GetSetting(
+			memory_budget_key,
+			default_memory_budget
+		);
+		evict_interval=server.Data().GetSetting(
+			evict_interval_key,
+			default_evict_interval
+		);
+		server.Pool().Enqueue(
+			evict_interval,
+			[this] () mutable {	evict();	}
+		);
+		
+		//	Columns loaded at about the same time
+		//	are retrieved from the backing store
+		//	together
+		fetch_window=server.Data().GetSetting(
+			fetch_window_key,
+			default_fetch_window
+		);
+		fetch_batch=server.Data().GetSetting(
+			fetch_batch_key,
+			default_fetch_batch
+		);
+		
+		//	Number of columns which may be in
+		//	each stage of preparation at once.
+		//
+		//	Loading waits on the backing store,
+		//	rather than a thread, so many loads
+		//	may be outstanding.
+		//
+		//	Generating, populating, and sending
+		//	each occupy a thread.  By default
+		//	they divide all but one of the pool's
+		//	threads between them, so that each
+		//	always has threads of its own, and
+		//	so that a thread remains free, since
+		//	a column being populated may wait on
+		//	its neighbours being generated.
+		Word workers=server.Pool().Count();
+		Word budget=(workers>1) ? (workers-1) : 1;
+		Word default_send=budget/4;
+		if (default_send==0) default_send=1;
+		Word default_populate=(budget>default_send) ? ((budget-default_send)/2) : 0;
+		if (default_populate==0) default_populate=1;
+		Word default_generate=(budget>(default_send+default_populate)) ? (budget-default_send-default_populate) : 1;
+		load_stage.Limit=server.Data().GetSetting(
+			load_concurrency_key,
+			default_load_concurrency
+		);
+		generate_stage.Limit=server.Data().GetSetting(
+			generate_concurrency_key,
+			default_generate
+		);
+		populate_stage.Limit=server.Data().GetSetting(
+			populate_concurrency_key,
+			default_populate
+		);
+		send_stage.Limit=server.Data().GetSetting(
+			send_concurrency_key,
+			default_send
+		);
+		Word total=generate_stage.Limit+populate_stage.Limit+send_stage.Limit;
+		if (
+			(generate_stage.Limit==0) ||
+			(populate_stage.Limit==0) ||
+			(send_stage.Limit==0) ||
+			(total>=workers)
+		) server.WriteLog(
+			String::Format(
+				stage_budget_warning,
+				total,
+				workers
+			),
+			Service::LogType::Warning
+		);
+		load_stage.Capacity=server.Data().GetSetting(
+			load_queue_key,
+			default_stage_queue
+		);
+		generate_stage.Capacity=server.Data().GetSetting(
+			generate_queue_key,
+			default_stage_queue
+		);
+		populate_stage.Capacity=server.Data().GetSetting(
+			populate_queue_key,
+			default_stage_queue
+		);
+		send_stage.Capacity=server.Data().GetSetting(
+			send_queue_key,
+			default_stage_queue
+		);
+		
 		//	Tie into the save loop
 		SaveManager::Get().Add([this] () mutable {	maintenance();	});
+		
+		//	Start sending buffered block
+		//	changes to clients
+		flush_interval=server.Data().GetSetting(
+			flush_interval_key,
+			default_flush_interval
+		);
+		server.Pool().Enqueue(
+			flush_interval,
+			[this] () mutable {	flush();	}
+		);
+		
+		//	Pace the sending of columns to
+		//	clients
+		send_rate=server.Data().GetSetting(
+			send_rate_key,
+			default_send_rate
+		);
+		send_burst=server.Data().GetSetting(
+			send_burst_key,
+			default_send_burst
+		);
+		send_high_water=server.Data().GetSetting(
+			send_high_water_key,
+			default_send_high_water
+		);
+		server.OnConnect.Add([this] (SmartPointer<Client> client) mutable {	begin_pacing(client);	});
+		server.OnDisconnect.Add([this] (SmartPointer<Client> client, const String &) mutable {	end_pacing(client);	});
 	
 	}
 	
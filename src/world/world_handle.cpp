@@ -1,5 +1,7 @@
 #include <world/world.hpp>
+#include <exception>
 #include <stdexcept>
+#include <utility>
 
 
 namespace MCPP {
@@ -17,9 +19,9 @@ namespace MCPP {
 			//	end interest in it
 			if (cache!=nullptr) cache->EndInterest();
 			
-			//	If we're holding the lock,
-			//	release it
-			if (locked) world->wlock.Release();
+			//	Commit any transaction in
+			//	progress
+			release();
 			
 			//	Prevent this from executing
 			//	again
@@ -30,6 +32,137 @@ namespace MCPP {
 	}
 	
 	
+	inline bool WorldHandle::transacting () const noexcept {
+	
+		//	Blocks set by populators are not
+		//	part of the transaction, population
+		//	is never undone
+		return (write==BlockWriteStrategy::Transactional) && (populate==0);
+	
+	}
+	
+	
+	//	The order in which transactions
+	//	acquire columns
+	static bool precedes (const ColumnID & a, const ColumnID & b) noexcept {
+	
+		if (a.Dimension!=b.Dimension) return a.Dimension<b.Dimension;
+		if (a.X!=b.X) return a.X<b.X;
+		
+		return a.Z<b.Z;
+	
+	}
+	
+	
+	void WorldHandle::acquire (ColumnContainer & column) const {
+	
+		//	Columns are acquired in order, a column
+		//	which comes before a column already held
+		//	may only be acquired if no other handle
+		//	has it, otherwise two handles could each
+		//	wait on a column the other holds
+		bool ordered=true;
+		for (auto c : held) {
+		
+			if (c==&column) return;
+			
+			if (!precedes(c->ID(),column.ID())) ordered=false;
+		
+		}
+		
+		//	Held columns must not be unloaded
+		column.Interested();
+		
+		bool acquired;
+		try {
+		
+			acquired=column.BeginWrite(id,ordered);
+		
+		} catch (...) {
+		
+			column.EndInterest();
+			
+			throw;
+		
+		}
+		
+		if (!acquired) {
+		
+			column.EndInterest();
+			
+			rollback();
+			
+			throw TransactionConflict();
+		
+		}
+		
+		try {
+		
+			held.Add(&column);
+		
+		} catch (...) {
+		
+			column.EndWrite();
+			column.EndInterest();
+			
+			throw;
+		
+		}
+	
+	}
+	
+	
+	void WorldHandle::release () const noexcept {
+	
+		for (auto column : held) {
+		
+			column->EndWrite();
+			column->EndInterest();
+		
+		}
+		
+		held.Clear();
+		undo.Clear();
+	
+	}
+	
+	
+	template <typename T>
+	auto WorldHandle::write_to (ColumnContainer & column, T callback) const -> decltype(callback()) {
+	
+		//	Transactions hold each column
+		//	until they end
+		if (transacting()) {
+		
+			acquire(column);
+			
+			return callback();
+		
+		}
+		
+		//	Otherwise write access is held only
+		//	for the duration of the write
+		column.BeginWrite(id,true);
+		
+		try {
+		
+			auto retr=callback();
+			
+			column.EndWrite();
+			
+			return retr;
+		
+		} catch (...) {
+		
+			column.EndWrite();
+			
+			throw;
+		
+		}
+	
+	}
+	
+	
 	inline ColumnContainer * WorldHandle::get_column_impl (ColumnID id) const {
 	
 		bool create;
@@ -134,8 +267,31 @@ namespace MCPP {
 			(target==ColumnState::Populated)
 		) target=ColumnState::Generated;
 		
+		//	A transaction which holds columns must
+		//	not wait for another column to be
+		//	prepared, since populating it may write
+		//	to a column the transaction holds, so it
+		//	rolls back and is retried once it holds
+		//	nothing
+		if (
+			transacting() &&
+			Exclusive() &&
+			!state_at_least(cache,target)
+		) {
+		
+			//	Nothing may be preparing the column,
+			//	it must be prepared in the background
+			//	or retrying would never succeed
+			world->when_populated(*cache,0);
+			
+			rollback();
+			
+			throw TransactionConflict();
+		
+		}
+		
 		//	Wait/process as necessary
-		if (!cache->WaitUntil(target)) world->process(*cache,this);
+		world->wait_until(*cache,target,this);
 		
 		//	If our access strategy is one
 		//	of the load-related strategies,
@@ -162,8 +318,30 @@ namespace MCPP {
 	}
 	
 	
+	//	Determines whether light must be updated
+	//	around a block which changes from one
+	//	block to another
+	static inline bool relights (Block from, Block to) noexcept {
+	
+		//	If light passes through or is emitted
+		//	by the new block differently, light
+		//	around it must be updated
+		return (
+			(GetLightOpacity(from.GetType())!=GetLightOpacity(to.GetType())) ||
+			(GetLightEmission(from.GetType())!=GetLightEmission(to.GetType()))
+		);
+	
+	}
+	
+	
 	inline bool WorldHandle::set_impl (ColumnContainer * column, BlockID id, Block block, bool force) const {
 	
+		//	Transactions hold the column before
+		//	reading from it, so that the block
+		//	being replaced cannot change before
+		//	it's remembered
+		if (transacting()) acquire(*column);
+	
 		//	Prepare event
 		BlockSetEvent event{
 			*this,
@@ -177,8 +355,31 @@ namespace MCPP {
 		//	here is permitted
 		if (!(force || world->can_set(event))) return false;
 		
-		//	Set block
-		column->SetBlock(id,block);
+		//	Write access is held only while the
+		//	block is set, never while handlers
+		//	run, otherwise a handler which writes
+		//	to a column a transaction holds could
+		//	wait on that transaction while it
+		//	waits on this column
+		bool changed=write_to(*column,[&] () {
+		
+			//	Remember the block being replaced,
+			//	so that the transaction may be rolled
+			//	back
+			if (transacting()) undo.EmplaceBack(column,id,event.From,block);
+			//	Another handle may have set the block
+			//	while handlers were consulted
+			else event.From=column->GetBlock(id);
+			
+			return column->SetBlock(id,block);
+		
+		});
+		
+		//	Arrange for the change to be sent
+		//	to clients if necessary
+		if (changed) world->add_changed(*column);
+		
+		if (relights(event.From,block)) world->relight(id);
 		
 		//	Fire event to notify listeners
 		//	that block has been set
@@ -187,36 +388,89 @@ namespace MCPP {
 		return true;
 	
 	}
+	
+	
+	void WorldHandle::rollback () const {
+	
+		//	Listeners may set blocks through this
+		//	handle, which must not disturb the
+		//	changes being undone
+		auto changes=std::move(undo);
+		undo.Clear();
+		
+		//	Every block is restored even if a
+		//	listener throws, the first exception
+		//	is rethrown once they have been
+		std::exception_ptr ex;
+		
+		try {
+		
+			//	Restore the newest change first, so
+			//	that each block ends up as it was
+			//	before the transaction
+			for (Word i=changes.Count();(i--)>0;) {
+			
+				const auto & t=changes[i];
+				auto column=t.Item<0>();
+				
+				BlockSetEvent event{
+					*this,
+					t.Item<1>(),
+					column->GetBlock(t.Item<1>()),
+					t.Item<2>()
+				};
+				
+				if (column->SetBlock(event.ID,event.To)) world->add_changed(*column);
+				
+				if (relights(event.From,event.To)) world->relight(event.ID);
+				
+				//	Listeners were told of the change
+				//	being undone, so they must be told
+				//	that it was undone
+				try {
+				
+					world->on_set(event);
+				
+				} catch (...) {
+				
+					if (!ex) ex=std::current_exception();
+				
+				}
+			
+			}
+		
+		} catch (...) {
+		
+			release();
+			
+			throw;
+		
+		}
+		
+		release();
+		
+		if (ex) std::rethrow_exception(ex);
+	
+	}
 
 
 	WorldHandle::WorldHandle (World * world, BlockWriteStrategy write, BlockAccessStrategy access)
 		:	write(write),
 			access(access),
 			world(world),
-			locked(false),
+			id(++world->writers),
 			cache(nullptr),
 			populate(0)
-	{
-	
-		//	If we're beginning a transaction,
-		//	begin it by acquiring the lock
-		//	at once
-		if (write==BlockWriteStrategy::Transactional) {
-		
-			world->wlock.Acquire();
-			
-			locked=true;
-		
-		}
-	
-	}
+	{	}
 	
 	
 	WorldHandle::WorldHandle (WorldHandle && other) noexcept
 	:	write(other.write),
 		access(other.access),
 		world(other.world),
-		locked(other.locked),
+		id(other.id),
+		held(std::move(other.held)),
+		undo(std::move(other.undo)),
 		cache(other.cache),
 		populate(other.populate)
 	{
@@ -242,7 +496,9 @@ namespace MCPP {
 			write=other.write;
 			access=other.access;
 			world=other.world;
-			locked=other.locked;
+			id=other.id;
+			held=std::move(other.held);
+			undo=std::move(other.undo);
 			cache=other.cache;
 			populate=other.populate;
 			
@@ -277,52 +533,12 @@ namespace MCPP {
 		//	for whatever reason, fail
 		if (column==nullptr) return false;
 		
-		//	Acquire the world lock if
-		//	necessary
-		bool locked=false;
-		if (!this->locked) {
-		
-			world->wlock.Acquire();
-			
-			locked=true;
-			this->locked=true;
-		
-		}
-		
-		bool retr;
-		try {
-		
-			retr=set_impl(
-				column,
-				id,
-				block,
-				force
-			);
-		
-		} catch (...) {
-		
-			//	Don't leak lock
-			if (locked) {
-			
-				world->wlock.Release();
-				
-				this->locked=false;
-				
-			}
-			
-			throw;
-		
-		}
-		
-		if (locked) {
-		
-			world->wlock.Release();
-			
-			this->locked=false;
-			
-		}
-		
-		return retr;
+		return set_impl(
+			column,
+			id,
+			block,
+			force
+		);
 	
 	}
 	
@@ -342,6 +558,10 @@ namespace MCPP {
 		//	a null column
 		if (column==nullptr) return retr;
 		
+		//	Blocks which a transaction reads must
+		//	not change until it ends
+		if (transacting()) acquire(*column);
+		
 		retr.Construct(column->GetBlock(id));
 		
 		return retr;
@@ -368,9 +588,473 @@ namespace MCPP {
 	}
 	
 	
+	Nullable<Word> WorldHandle::GetHeight (Int32 x, Int32 z, SByte dimension, std::nothrow_t) const {
+	
+		Nullable<Word> retr;
+		
+		BlockID id{x,0,z,dimension};
+		
+		auto * column=get_column(
+			id.GetContaining(),
+			true
+		);
+		
+		if (column==nullptr) return retr;
+		
+		if (transacting()) acquire(*column);
+		
+		auto offset=id.GetOffset();
+		retr.Construct(column->GetHeight(offset%16,offset/16));
+		
+		return retr;
+	
+	}
+	
+	
+	static const char * height_retrieve_error="Height could not be retrieved";
+	
+	
+	Word WorldHandle::GetHeight (Int32 x, Int32 z, SByte dimension) const {
+	
+		auto retr=GetHeight(
+			x,
+			z,
+			dimension,
+			std::nothrow
+		);
+		
+		if (retr.IsNull()) throw std::runtime_error(height_retrieve_error);
+		
+		return *retr;
+	
+	}
+	
+	
+	//	Orders the corners of a region so that
+	//	the first has the smallest co-ordinates
+	static void bounds (BlockID a, BlockID b, BlockID & min, BlockID & max) noexcept {
+	
+		min.X=(a.X<b.X) ? a.X : b.X;
+		min.Y=(a.Y<b.Y) ? a.Y : b.Y;
+		min.Z=(a.Z<b.Z) ? a.Z : b.Z;
+		max.X=(a.X<b.X) ? b.X : a.X;
+		max.Y=(a.Y<b.Y) ? b.Y : a.Y;
+		max.Z=(a.Z<b.Z) ? b.Z : a.Z;
+		min.Dimension=a.Dimension;
+		max.Dimension=a.Dimension;
+	
+	}
+	
+	
+	//	Determines the index of a block within
+	//	a region, x varies fastest, then z, then
+	//	y
+	static Word region_index (const BlockID & min, const BlockID & max, Int32 x, Word y, Int32 z) noexcept {
+	
+		Word width=static_cast<Word>(max.X-min.X)+1;
+		Word depth=static_cast<Word>(max.Z-min.Z)+1;
+		
+		return (
+			(
+				(
+					(y-min.Y)*depth
+				)+static_cast<Word>(z-min.Z)
+			)*width
+		)+static_cast<Word>(x-min.X);
+	
+	}
+	
+	
+	//	Invokes a callback for each column which
+	//	a region intersects, with the part of the
+	//	region within that column
+	template <typename T>
+	static void for_each_column (const BlockID & min, const BlockID & max, T callback) {
+	
+		auto first=min.GetContaining();
+		auto last=max.GetContaining();
+		
+		for (Int32 z=first.Z;z<=last.Z;++z) for (Int32 x=first.X;x<=last.X;++x) {
+		
+			ColumnID id{x,z,min.Dimension};
+			
+			BlockID lo=min;
+			BlockID hi=max;
+			if (lo.X<(x*16)) lo.X=x*16;
+			if (hi.X>((x*16)+15)) hi.X=(x*16)+15;
+			if (lo.Z<(z*16)) lo.Z=z*16;
+			if (hi.Z>((z*16)+15)) hi.Z=(z*16)+15;
+			
+			callback(id,lo,hi);
+		
+		}
+	
+	}
+	
+	
+	template <typename T>
+	Word WorldHandle::set_region (
+		ColumnContainer & column,
+		const BlockID & min,
+		const BlockID & max,
+		const BlockID & lo,
+		const BlockID & hi,
+		bool force,
+		T callback
+	) const {
+	
+		//	Determine what each block will become,
+		//	and unless handlers must be consulted
+		//	set them, under a single acquisition of
+		//	the column's lock, so that the column's
+		//	changes are sent together
+		Vector<BlockSetEvent> events;
+		Vector<Tuple<Word,Block>> blocks;
+		bool changed=false;
+		auto prepare=[&] () {
+		
+			blocks=Vector<Tuple<Word,Block>>(events.Count());
+			for (auto & event : events) blocks.EmplaceBack(event.ID.GetOffset(),event.To);
+			
+			if (transacting()) for (auto & event : events) undo.EmplaceBack(&column,event.ID,event.From,event.To);
+		
+		};
+		auto read=[&] () {
+		
+			bool retr=false;
+			column.Acquire();
+			
+			try {
+			
+				for (Word y=lo.Y;y<=hi.Y;++y) for (Int32 z=lo.Z;z<=hi.Z;++z) for (Int32 x=lo.X;x<=hi.X;++x) {
+				
+					BlockID id{x,static_cast<Byte>(y),z,lo.Dimension};
+					auto from=column.Read(id.GetOffset());
+					
+					Block to;
+					if (callback(region_index(min,max,x,y,z),from,to)) events.Add(BlockSetEvent{*this,id,from,to});
+				
+				}
+				
+				if (force && (events.Count()!=0)) {
+				
+					prepare();
+					
+					retr=column.SetBlocksAcquired(blocks);
+				
+				}
+			
+			} catch (...) {
+			
+				column.Release();
+				
+				throw;
+			
+			}
+			
+			column.Release();
+			
+			return retr;
+		
+		};
+		
+		//	Transactions hold the column before
+		//	reading from it, so that the blocks
+		//	being replaced cannot change before
+		//	they're remembered
+		if (transacting()) acquire(column);
+		
+		//	Write access is held only while blocks
+		//	are set, never while handlers run (see
+		//	set_impl)
+		if (force) changed=write_to(column,read);
+		else read();
+		
+		//	Handlers may read from the world, so
+		//	they're consulted without the column's
+		//	lock held, and the permitted blocks are
+		//	set afterwards
+		if (!force) {
+		
+			Vector<BlockSetEvent> permitted(events.Count());
+			for (auto & event : events) if (world->can_set(event)) permitted.Add(event);
+			
+			events=std::move(permitted);
+			
+			if (events.Count()==0) return 0;
+			
+			changed=write_to(column,[&] () {
+			
+				prepare();
+				
+				return column.SetBlocks(blocks);
+			
+			});
+		
+		}
+		
+		if (changed) world->add_changed(column);
+		
+		for (auto & event : events) if (relights(event.From,event.To)) world->relight(event.ID);
+		
+		for (auto & event : events) world->on_set(event);
+		
+		return events.Count();
+	
+	}
+	
+	
+	template <typename T>
+	Vector<RegionResult> WorldHandle::write_region (BlockID a, BlockID b, bool force, T callback) const {
+	
+		BlockID min;
+		BlockID max;
+		bounds(a,b,min,max);
+		
+		Vector<RegionResult> retr;
+		
+		for_each_column(min,max,[&] (const ColumnID & id, const BlockID & lo, const BlockID & hi) {
+		
+			RegionResult result{id,false,0};
+			
+			auto * column=get_column(id,false);
+			
+			if (column!=nullptr) {
+			
+				result.Retrieved=true;
+				result.Count=set_region(*column,min,max,lo,hi,force,callback);
+			
+			}
+			
+			retr.Add(result);
+		
+		});
+		
+		return retr;
+	
+	}
+	
+	
+	template <typename T>
+	Vector<RegionResult> WorldHandle::read_region (BlockID a, BlockID b, T callback) const {
+	
+		BlockID min;
+		BlockID max;
+		bounds(a,b,min,max);
+		
+		Vector<RegionResult> retr;
+		
+		//	Reused for each column
+		Vector<Word> offsets;
+		Vector<Word> indices;
+		Vector<Block> blocks;
+		
+		for_each_column(min,max,[&] (const ColumnID & id, const BlockID & lo, const BlockID & hi) {
+		
+			RegionResult result{id,false,0};
+			
+			auto * column=get_column(id,true);
+			
+			if (column!=nullptr) {
+			
+				result.Retrieved=true;
+				result.Count=Volume(lo,hi);
+				
+				if (transacting()) acquire(*column);
+				
+				offsets.Clear();
+				indices.Clear();
+				blocks.Clear();
+				for (Word y=lo.Y;y<=hi.Y;++y) for (Int32 z=lo.Z;z<=hi.Z;++z) for (Int32 x=lo.X;x<=hi.X;++x) {
+				
+					BlockID location{x,static_cast<Byte>(y),z,lo.Dimension};
+					
+					offsets.Add(location.GetOffset());
+					indices.Add(region_index(min,max,x,y,z));
+					blocks.EmplaceBack();
+				
+				}
+				
+				//	The entire part of the region within
+				//	this column is read at once, so that
+				//	it's consistent
+				column->GetBlocks(offsets.begin(),blocks.begin(),blocks.Count());
+				
+				for (Word i=0;i<blocks.Count();++i) callback(indices[i],blocks[i]);
+			
+			}
+			
+			retr.Add(result);
+		
+		});
+		
+		return retr;
+	
+	}
+	
+	
+	Word WorldHandle::Volume (BlockID a, BlockID b) noexcept {
+	
+		BlockID min;
+		BlockID max;
+		bounds(a,b,min,max);
+		
+		return (
+			(static_cast<Word>(max.X-min.X)+1)*
+			(static_cast<Word>(max.Y-min.Y)+1)*
+			(static_cast<Word>(max.Z-min.Z)+1)
+		);
+	
+	}
+	
+	
+	Vector<RegionResult> WorldHandle::Fill (BlockID a, BlockID b, Block block, bool force) const {
+	
+		return write_region(a,b,force,[&] (Word, Block, Block & to) {
+		
+			to=block;
+			
+			return true;
+		
+		});
+	
+	}
+	
+	
+	Vector<RegionResult> WorldHandle::Replace (BlockID a, BlockID b, Block find, Block replace, bool force) const {
+	
+		return write_region(a,b,force,[&] (Word, Block from, Block & to) {
+		
+			if (!(
+				(from.GetType()==find.GetType()) &&
+				(from.GetMetadata()==find.GetMetadata())
+			)) return false;
+			
+			to=replace;
+			
+			return true;
+		
+		});
+	
+	}
+	
+	
+	Vector<RegionResult> WorldHandle::CopyRegion (BlockID a, BlockID b, BlockID destination, bool force) const {
+	
+		BlockID min;
+		BlockID max;
+		bounds(a,b,min,max);
+		
+		//	The destination region, not extending
+		//	above the top of the world
+		Word top=static_cast<Word>(destination.Y)+static_cast<Word>(max.Y-min.Y);
+		BlockID end{
+			destination.X+(max.X-min.X),
+			static_cast<Byte>((top>255) ? 255 : top),
+			destination.Z+(max.Z-min.Z),
+			destination.Dimension
+		};
+		
+		//	The region is copied one destination
+		//	column at a time, so that at most one
+		//	column's worth of blocks is buffered.
+		//
+		//	So that the source may overlap the
+		//	destination, destination columns are
+		//	visited furthest along the direction
+		//	of the copy first, which means that
+		//	no column is written before every
+		//	column which is read from it has been
+		//	copied
+		auto first=destination.GetContaining();
+		auto last=end.GetContaining();
+		Int32 step_x=(destination.X>min.X) ? -1 : 1;
+		Int32 step_z=(destination.Z>min.Z) ? -1 : 1;
+		Int32 begin_x=(step_x<0) ? last.X : first.X;
+		Int32 end_x=((step_x<0) ? first.X : last.X)+step_x;
+		Int32 begin_z=(step_z<0) ? last.Z : first.Z;
+		Int32 end_z=((step_z<0) ? first.Z : last.Z)+step_z;
+		
+		Vector<RegionResult> retr;
+		
+		//	Reused for each column
+		Vector<Nullable<Block>> blocks;
+		
+		for (Int32 z=begin_z;z!=end_z;z+=step_z) for (Int32 x=begin_x;x!=end_x;x+=step_x) {
+		
+			//	The part of the destination within
+			//	this column, and where it's copied
+			//	from
+			BlockID lo=destination;
+			BlockID hi=end;
+			if (lo.X<(x*16)) lo.X=x*16;
+			if (hi.X>((x*16)+15)) hi.X=(x*16)+15;
+			if (lo.Z<(z*16)) lo.Z=z*16;
+			if (hi.Z>((z*16)+15)) hi.Z=(z*16)+15;
+			BlockID source_lo{
+				min.X+(lo.X-destination.X),
+				min.Y,
+				min.Z+(lo.Z-destination.Z),
+				min.Dimension
+			};
+			BlockID source_hi{
+				source_lo.X+(hi.X-lo.X),
+				static_cast<Byte>(min.Y+(hi.Y-lo.Y)),
+				source_lo.Z+(hi.Z-lo.Z),
+				min.Dimension
+			};
+			
+			Word volume=Volume(source_lo,source_hi);
+			blocks.Clear();
+			for (Word i=0;i<volume;++i) blocks.EmplaceBack();
+			
+			read_region(source_lo,source_hi,[&] (Word index, Block block) {	blocks[index].Construct(block);	});
+			
+			//	Both parts have the same dimensions,
+			//	so a block's index within one is its
+			//	index within the other
+			for (auto & result : write_region(lo,hi,force,[&] (Word index, Block, Block & to) {
+			
+				const auto & block=blocks[index];
+				if (block.IsNull()) return false;
+				
+				to=*block;
+				
+				return true;
+			
+			})) retr.Add(result);
+		
+		}
+		
+		return retr;
+	
+	}
+	
+	
+	Vector<RegionResult> WorldHandle::Read (BlockID a, BlockID b, Block * buffer) const {
+	
+		return read_region(a,b,[&] (Word index, Block block) {	buffer[index]=block;	});
+	
+	}
+	
+	
+	void WorldHandle::Commit () const noexcept {
+	
+		release();
+	
+	}
+	
+	
+	void WorldHandle::Rollback () const {
+	
+		rollback();
+	
+	}
+	
+	
 	bool WorldHandle::Exclusive () const noexcept {
 	
-		return locked;
+		return held.Count()!=0;
 	
 	}
 	